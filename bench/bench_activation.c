@@ -0,0 +1,221 @@
+//*****************************************************************************
+//************ BENCH_ACTIVATION.C - Per-activation library overhead ***********
+//************               Author: Livio Bisogni                 ************
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Measure the CPU time the library spends at each activation of a task
+    with an empty body, measured on the thread CPU clock:
+        * wait_for_period: task_update_stats + task_wait_for_period
+        * run_periodic:    the loop of task_run_periodic
+        * update_stats:    task_update_stats alone (no wait)
+        * get_stats:       task_get_stats (reader side)
+
+    Usage: bench_activation [activations]
+    Note: tasks are created with SCHED_RR, hence root privileges are needed.
+_____________________________________________________________________________*/
+
+
+#include "bench_report.h"
+#include "easy_pthread_task.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    LOCAL CONSTANTS
+_____________________________________________________________________________*/
+#define BENCH       "activation"
+#define ACTIVATIONS 2000     // default number of periodic activations
+#define CALLS       1000000  // calls of the functions that do not wait
+#define PERIOD      1        // task period                               [ms]
+#define PRIO        80       // task priority
+#define RING_LEN    1024     // response times kept by each task
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    GLOBAL VARIABLES (definition)
+_____________________________________________________________________________*/
+static unsigned long activations;  // number of periodic activations
+static double        cost;         // CPU time per activation (or call)  [ns]
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    CPU_NOW:    Return the CPU time of the calling thread, in [ns]
+_____________________________________________________________________________*/
+
+static int64_t cpu_now()
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t);
+
+    return timespec2ns(t);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    WAIT_TASK:  Periodic task recording a constant response time, then
+                waiting for the next period
+_____________________________________________________________________________*/
+
+static void *wait_task(void *arg)
+{
+    int           j;      // task index
+    unsigned long m;      // activation index
+    int64_t       start;  // CPU time at the first activation          [ns]
+
+    j = task_get_index(arg);
+    task_set_activation(j);
+    start = cpu_now();
+
+    for (m = 0; m < activations; m++) {
+        task_update_stats(j, 0.01);
+        task_wait_for_period(j);
+    }
+
+    cost = (double)(cpu_now() - start) / activations;
+
+    return NULL;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    EMPTY_BODY: Body of run_task, ending after the given activations
+_____________________________________________________________________________*/
+
+static int empty_body(int j, void *ctx)
+{
+    unsigned long *n;  // number of activations so far
+
+    (void)j;
+    n = (unsigned long *)ctx;
+
+    return ++(*n) >= activations;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    RUN_TASK:   Periodic task run by task_run_periodic
+_____________________________________________________________________________*/
+
+static void *run_task(void *arg)
+{
+    int           j;      // task index
+    unsigned long n;      // number of activations so far
+    int64_t       start;  // CPU time at the first activation          [ns]
+
+    j     = task_get_index(arg);
+    n     = 0;
+    start = cpu_now();
+
+    task_run_periodic(j, empty_body, &n);
+
+    cost = (double)(cpu_now() - start) / activations;
+
+    return NULL;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    UPDATE_TASK:    Task calling task_update_stats without ever waiting
+_____________________________________________________________________________*/
+
+static void *update_task(void *arg)
+{
+    int           j;      // task index
+    unsigned long m;      // call index
+    int64_t       start;  // CPU time before the first call            [ns]
+
+    j     = task_get_index(arg);
+    start = cpu_now();
+
+    for (m = 0; m < CALLS; m++)
+        task_update_stats(j, (double)(m % 100) / 10);
+
+    cost = (double)(cpu_now() - start) / CALLS;
+
+    return NULL;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    RUN_CASE:   Run a task with body task and return its cost [ns], or -1 if
+                it could not be created
+_____________________________________________________________________________*/
+
+static double run_case(void *(*task)(void *))
+{
+    struct task_attr attr;
+    int              j;    // task index
+    int              ret;
+
+    task_attr_init(&attr);
+    attr.rt_store = RT_STORE_RING;
+    attr.rt_cap   = RING_LEN;
+
+    j   = task_alloc();
+    ret = task_create_ex(task, j, PERIOD, PERIOD, PRIO, &attr);
+    if (ret != 0) {
+        fprintf(stderr, "task_create_ex failed (%d)\n", ret);
+        return -1;
+    }
+    task_wait_for_end(j);
+
+    return cost;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    MAIN
+_____________________________________________________________________________*/
+
+int main(int argc, char *argv[])
+{
+    struct task_stats st;
+    unsigned long     m;      // call index
+    int64_t           start;  // CPU time before the first call        [ns]
+    int               j;      // task index
+
+    activations = (argc > 1) ? strtoul(argv[1], NULL, 10) : ACTIVATIONS;
+    if (activations == 0)
+        activations = ACTIVATIONS;
+
+    bench_report_header();
+
+    if (run_case(wait_task) < 0)
+        return EXIT_FAILURE;
+    bench_report(BENCH, "wait_for_period", "cpu_per_activation", cost, "ns");
+
+    if (run_case(run_task) < 0)
+        return EXIT_FAILURE;
+    bench_report(BENCH, "run_periodic", "cpu_per_activation", cost, "ns");
+
+    if (run_case(update_task) < 0)
+        return EXIT_FAILURE;
+    bench_report(BENCH, "update_stats", "cpu_per_call", cost, "ns");
+
+    /* Reader side, on a task that is not running (no retries) */
+    j = task_alloc();
+    if (task_create_ex(update_task, j, PERIOD, PERIOD, PRIO, NULL) != 0)
+        return EXIT_FAILURE;
+    task_wait_for_end(j);
+    start = cpu_now();
+    for (m = 0; m < CALLS; m++)
+        task_get_stats(j, &st);
+    bench_report(BENCH, "get_stats", "cpu_per_call",
+                 (double)(cpu_now() - start) / CALLS, "ns");
+
+    return EXIT_SUCCESS;
+}
+//-----------------------------------------------------------------------------
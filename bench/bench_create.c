@@ -0,0 +1,146 @@
+//*****************************************************************************
+//************** BENCH_CREATE.C - Task creation and startup time **************
+//**************              Author: Livio Bisogni             **************
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Create and join tasks one at a time, and measure the duration of the
+    task_create_ex call (create) and the time from its beginning to the
+    first instruction of the task function (startup), i.e., including the
+    set up of the thread by the library, with:
+        * default: default attributes
+        * ring:    a small ring response time store
+        * rt_mem:  locked memory, pre-faulted store and stack
+
+    Usage: bench_create [tasks]
+    Note: tasks are created with SCHED_RR, hence root privileges are needed.
+_____________________________________________________________________________*/
+
+
+#include "bench_report.h"
+#include "easy_pthread_task.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    LOCAL CONSTANTS
+_____________________________________________________________________________*/
+#define BENCH    "create"
+#define TASKS    200     // default number of created tasks
+#define PERIOD   10      // task period                                   [ms]
+#define PRIO     80      // task priority
+#define RING_LEN 1024    // response times kept by the ring store
+#define MEM_CAP  100000  // response times kept by the rt_mem store
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    GLOBAL VARIABLES (definition)
+_____________________________________________________________________________*/
+static struct timespec t_body;  // time of the first instruction of the task
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    EMPTY_TASK: Record the time it started at, then end
+_____________________________________________________________________________*/
+
+static void *empty_task(void *arg)
+{
+    (void)arg;
+
+    clock_gettime(CLOCK_MONOTONIC, &t_body);
+
+    return NULL;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    RUN_CASE:   Create and join n tasks with attributes attr, and report the
+                create and startup times as the case cas.
+                Return 0 in case of success, -1 otherwise
+_____________________________________________________________________________*/
+
+static int run_case(const char *cas, const struct task_attr *attr, int n)
+{
+    int64_t        *create;   // duration of the task_create_ex calls  [ns]
+    int64_t        *startup;  // startup times of the tasks            [ns]
+    struct timespec t_start;  // time before task_create_ex
+    struct timespec t_ret;    // time after task_create_ex
+    char            name[32]; // case name of the startup times
+    int             j;        // task index
+    int             i;        // for-loop index
+    int             ret;
+
+    create  = malloc(n * sizeof(*create));
+    startup = malloc(n * sizeof(*startup));
+    if (!create || !startup) {
+        perror("malloc failed!");
+        exit(EXIT_FAILURE);
+    }
+
+    for (i = 0; i < n; i++) {
+        j = task_alloc();
+        clock_gettime(CLOCK_MONOTONIC, &t_start);
+        ret = task_create_ex(empty_task, j, PERIOD, PERIOD, PRIO, attr);
+        clock_gettime(CLOCK_MONOTONIC, &t_ret);
+        if (ret != 0) {
+            fprintf(stderr, "task_create_ex failed (%d)\n", ret);
+            return -1;
+        }
+        task_wait_for_end(j);
+
+        create[i]  = get_time_diff_in_ns(&t_ret, &t_start);
+        startup[i] = get_time_diff_in_ns(&t_body, &t_start);
+    }
+
+    snprintf(name, sizeof(name), "%s_create", cas);
+    bench_report_dist(BENCH, name, create, n, "ns");
+    snprintf(name, sizeof(name), "%s_startup", cas);
+    bench_report_dist(BENCH, name, startup, n, "ns");
+
+    free(create);
+    free(startup);
+
+    return 0;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    MAIN
+_____________________________________________________________________________*/
+
+int main(int argc, char *argv[])
+{
+    struct task_attr attr;
+    int              n;  // number of tasks per case
+
+    n = (argc > 1) ? atoi(argv[1]) : TASKS;
+    if (n <= 0)
+        n = TASKS;
+
+    bench_report_header();
+
+    task_attr_init(&attr);
+    if (run_case("default", &attr, n) < 0)
+        return EXIT_FAILURE;
+
+    attr.rt_store = RT_STORE_RING;
+    attr.rt_cap   = RING_LEN;
+    if (run_case("ring", &attr, n) < 0)
+        return EXIT_FAILURE;
+
+    /* Last, as the process memory stays locked */
+    attr.rt_cap = MEM_CAP;
+    attr.rt_mem = 1;
+    if (run_case("rt_mem", &attr, n) < 0)
+        return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,144 @@
+//*****************************************************************************
+//*********** BENCH_FALSE_SHARING.C - Per-activation statistics cost **********
+//***********                Author: Livio Bisogni                   **********
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Measure the cost of the per-activation statistics updates (i.e., the
+    writes to the hot block of task_par) with 2, 4, 8 and 16 tasks running
+    concurrently, each one pinned to a different core (modulo the number of
+    online cores). Without false sharing, the cost should not grow with the
+    number of tasks, as long as there are enough cores. Each case "tasks<n>"
+    reports the number of cores and the average cost per activation.
+
+    Usage: bench_false_sharing [activations]
+    Note: tasks are created with SCHED_RR, hence root privileges are needed.
+_____________________________________________________________________________*/
+
+
+#define _GNU_SOURCE  // pthread_setaffinity_np
+#include "bench_report.h"
+#include "easy_pthread_task.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    LOCAL CONSTANTS
+_____________________________________________________________________________*/
+#define BENCH       "false_sharing"
+#define MAX_TASKS   16        // highest number of concurrent tasks
+#define ACTIVATIONS 2000000   // default number of activations per task
+#define RING_LEN    1024      // response times kept by each task
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    GLOBAL VARIABLES (definition)
+_____________________________________________________________________________*/
+static pthread_barrier_t start_barrier;  // lets all the tasks start together
+static unsigned long     activations;    // number of activations per task
+static double            cost[TASK_MAX];  // per-activation cost of each task
+static long              n_cpus;          // number of online cores
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    BENCH_TASK: Pin itself to a core, then perform the statistics updates of
+                an activation (without actually waiting for the period) and
+                record their average cost [ns], measured on the thread CPU
+                clock so that preemption by the other tasks is not counted
+_____________________________________________________________________________*/
+
+static void *bench_task(void *arg)
+{
+    int             j;  // task index
+    unsigned long   m;  // activation index
+    cpu_set_t       cpus;
+    struct timespec t_start;
+    struct timespec t_end;
+
+    j = task_get_index(arg);
+
+    CPU_ZERO(&cpus);
+    CPU_SET(j % n_cpus, &cpus);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+
+    pthread_barrier_wait(&start_barrier);
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t_start);
+
+    for (m = 0; m < activations; m++) {
+        task_set_rt_value(j, m, (double)(m % 100) / 10);
+        task_increment_rt_tot(j, (double)(m % 100) / 10);
+        task_set_rt_max(j, task_compute_rt_max(j));
+        task_set_rt_min(j, task_compute_rt_min(j));
+        task_set_rt_avg(j, task_compute_rt_avg(j));
+        task_set_util_inst(j, task_compute_util_inst(j));
+        task_set_ex_tot(j, m);
+    }
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t_end);
+    cost[j] = (double)get_time_diff_in_ns(&t_end, &t_start) / activations;
+
+    return NULL;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    MAIN
+_____________________________________________________________________________*/
+
+int main(int argc, char *argv[])
+{
+    struct task_attr attr;
+    int              j[MAX_TASKS];  // task indexes
+    int              n;             // number of concurrent tasks
+    int              i;             // for-loop index
+    int              ret;
+    double           cost_avg;      // average per-activation cost       [ns]
+    char             cas[24];       // case name ("tasks" and any int)
+
+    activations = (argc > 1) ? strtoul(argv[1], NULL, 10) : ACTIVATIONS;
+    if (activations == 0)
+        activations = ACTIVATIONS;
+    n_cpus      = sysconf(_SC_NPROCESSORS_ONLN);
+
+    task_attr_init(&attr);
+    attr.rt_store = RT_STORE_RING;
+    attr.rt_cap   = RING_LEN;
+
+    bench_report_header();
+
+    for (n = 2; n <= MAX_TASKS; n *= 2) {
+        pthread_barrier_init(&start_barrier, NULL, n);
+
+        for (i = 0; i < n; i++) {
+            j[i] = task_alloc();
+            ret  = task_create_ex(bench_task, j[i], 1000, 1000, 1, &attr);
+            if (ret != 0) {
+                fprintf(stderr, "task_create_ex failed (%d)\n", ret);
+                return EXIT_FAILURE;
+            }
+        }
+
+        cost_avg = 0;
+        for (i = 0; i < n; i++) {
+            task_wait_for_end(j[i]);
+            cost_avg += cost[j[i]] / n;
+        }
+
+        snprintf(cas, sizeof(cas), "tasks%d", n);
+        bench_report(BENCH, cas, "cpus", n_cpus, "cores");
+        bench_report(BENCH, cas, "cpu_per_activation", cost_avg, "ns");
+        pthread_barrier_destroy(&start_barrier);
+    }
+
+    return EXIT_SUCCESS;
+}
+//-----------------------------------------------------------------------------
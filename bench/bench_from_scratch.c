@@ -0,0 +1,154 @@
+//*****************************************************************************
+//********* BENCH_FROM_SCRATCH.C - Cost of the from-scratch statistics ********
+//*********               Author: Livio Bisogni                    ***********
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Measure the cost of each task_compute_*_from_scratch function (i.e., a
+    full pass over the stored response times) as the number of samples
+    grows, from 10^3 up to the given maximum (10^6 by default), with each
+    instruction set of the reductions (case "<function>_<isa>") and, with
+    the best one, split among a thread per online core ("<function>_mt").
+    Each metric "n<samples>" is the (wall-clock) cost of one call.
+
+    Usage: bench_from_scratch [max_samples]
+    Note: tasks are created with SCHED_RR, hence root privileges are needed.
+_____________________________________________________________________________*/
+
+
+#include "bench_report.h"
+#include "easy_pthread_reduce.h"
+#include "easy_pthread_task.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    LOCAL CONSTANTS
+_____________________________________________________________________________*/
+#define BENCH       "from_scratch"
+#define MIN_SAMPLES 1000      // smallest number of samples
+#define MAX_SAMPLES 1000000   // default largest number of samples
+#define WORK        20000000  // samples scanned per function and size
+#define PERIOD      1000      // task period (the task never waits)       [ms]
+#define PRIO        1         // task priority
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    GLOBAL VARIABLES (definition)
+_____________________________________________________________________________*/
+static const char *names[] = {"rt_max", "rt_min", "rt_avg", "std_dev"};
+static const char *isas[]  = {"scalar", "sse2", "avx2", "mt"};
+static double (*const funcs[])(int) = {
+    task_compute_rt_max_from_scratch, task_compute_rt_min_from_scratch,
+    task_compute_rt_avg_from_scratch, task_compute_std_dev_from_scratch};
+#define N_FUNCS (sizeof(funcs) / sizeof(funcs[0]))
+#define N_ISAS  (sizeof(isas) / sizeof(isas[0]))
+
+static unsigned long   samples;  // number of samples of the current run
+static double          cost[N_ISAS][N_FUNCS];  // cost of a call, or -1  [ns]
+static volatile double sink;     // keeps the results alive
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    SCRATCH_TASK:   Record samples response times, then time each function
+_____________________________________________________________________________*/
+
+static void *scratch_task(void *arg)
+{
+    int             j;     // task index
+    unsigned long   m;     // sample index
+    unsigned long   reps;  // calls per function
+    unsigned long   r;     // for-loop index
+    unsigned        i;     // for-loop index
+    unsigned        f;     // for-loop index
+    struct timespec t_start;
+    struct timespec t_end;
+
+    j = task_get_index(arg);
+
+    for (m = 0; m < samples; m++)
+        task_update_stats(j, (double)((m * 7919) % 1000) / 100);
+
+    reps = WORK / samples;
+    if (reps == 0)
+        reps = 1;
+
+    for (i = 0; i < N_ISAS; i++) {
+        if (i == N_ISAS - 1) {  // mt: best instruction set, all the cores
+            rt_reduce_set_isa(-1);
+            rt_reduce_set_threads(0);
+        } else if (rt_reduce_set_isa(i) != (int)i) {
+            for (f = 0; f < N_FUNCS; f++)
+                cost[i][f] = -1;  // not supported
+            continue;
+        }
+
+        for (f = 0; f < N_FUNCS; f++) {
+            sink = funcs[f](j);  // warm-up
+            clock_gettime(CLOCK_MONOTONIC, &t_start);
+            for (r = 0; r < reps; r++)
+                sink = funcs[f](j);
+            clock_gettime(CLOCK_MONOTONIC, &t_end);
+            cost[i][f] = (double)get_time_diff_in_ns(&t_end, &t_start) / reps;
+        }
+    }
+
+    rt_reduce_set_isa(-1);
+    rt_reduce_set_threads(1);
+
+    return NULL;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    MAIN
+_____________________________________________________________________________*/
+
+int main(int argc, char *argv[])
+{
+    struct task_attr attr;
+    unsigned long    max_samples;  // largest number of samples
+    char             metric[32];   // name of the metric
+    char             cas[32];      // name of the case
+    unsigned         i;            // for-loop index
+    unsigned         f;            // for-loop index
+    int              j;            // task index
+    int              ret;
+
+    max_samples = (argc > 1) ? strtoul(argv[1], NULL, 10) : MAX_SAMPLES;
+    if (max_samples < MIN_SAMPLES)
+        max_samples = MAX_SAMPLES;
+
+    bench_report_header();
+
+    for (samples = MIN_SAMPLES; samples <= max_samples; samples *= 10) {
+        task_attr_init(&attr);
+        attr.rt_cap = samples;
+
+        j   = task_alloc();
+        ret = task_create_ex(scratch_task, j, PERIOD, PERIOD, PRIO, &attr);
+        if (ret != 0) {
+            fprintf(stderr, "task_create_ex failed (%d)\n", ret);
+            return EXIT_FAILURE;
+        }
+        task_wait_for_end(j);
+
+        snprintf(metric, sizeof(metric), "n%lu", samples);
+        for (i = 0; i < N_ISAS; i++)
+            for (f = 0; f < N_FUNCS; f++) {
+                if (cost[i][f] < 0)
+                    continue;
+                snprintf(cas, sizeof(cas), "%s_%s", names[f], isas[i]);
+                bench_report(BENCH, cas, metric, cost[i][f], "ns");
+            }
+    }
+
+    return EXIT_SUCCESS;
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,197 @@
+//*****************************************************************************
+//************ BENCH_LATENCY.C - Wake-up latency, idle and loaded *************
+//************              Author: Livio Bisogni                 *************
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Measure the distribution (and a histogram) of the wake-up latency of a
+    periodic task (see task_get_lat_value), first on an idle system, then
+    with a non real-time load thread per online core, each one sweeping a
+    buffer larger than the caches and yielding the CPU from time to time.
+
+    Usage: bench_latency [activations]
+    Note: tasks are created with SCHED_RR, hence root privileges are needed.
+_____________________________________________________________________________*/
+
+
+#include "bench_report.h"
+#include "easy_pthread_task.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    LOCAL CONSTANTS
+_____________________________________________________________________________*/
+#define BENCH       "latency"
+#define ACTIVATIONS 2000      // default number of activations
+#define PERIOD      1         // task period                              [ms]
+#define PRIO        80        // task priority
+#define LOAD_BUF    (32 << 20)  // buffer swept by each load thread     [byte]
+#define MAX_LOADS   64        // highest number of load threads
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    GLOBAL VARIABLES (definition)
+_____________________________________________________________________________*/
+static unsigned long activations;  // number of activations
+static int64_t      *lat;          // wake-up latencies of the last run  [ns]
+static unsigned long n_lat;        // number of latencies in lat
+static volatile int  load_stop;    // 1 when the load threads must exit
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    LOAD_THREAD:    Sweep a large buffer (cache and TLB pressure), yielding
+                    the CPU after each sweep, until load_stop is set
+_____________________________________________________________________________*/
+
+static void *load_thread(void *arg)
+{
+    char  *buf;  // swept buffer
+    size_t i;    // for-loop index
+
+    (void)arg;
+
+    buf = malloc(LOAD_BUF);
+    if (!buf) {
+        perror("malloc failed!");
+        exit(EXIT_FAILURE);
+    }
+
+    while (!load_stop) {
+        for (i = 0; i < LOAD_BUF; i += CACHE_LINE)
+            buf[i]++;
+        sched_yield();
+    }
+
+    free(buf);
+
+    return NULL;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    LAT_BODY:   Body of lat_task, ending after the given activations
+_____________________________________________________________________________*/
+
+static int lat_body(int j, void *ctx)
+{
+    (void)ctx;
+
+    return task_get_lat_count(j) >= activations;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    LAT_TASK:   Periodic task with an empty body; before ending, it copies its
+                wake-up latencies into lat (they are freed when joined)
+_____________________________________________________________________________*/
+
+static void *lat_task(void *arg)
+{
+    int           j;  // task index
+    unsigned long k;  // for-loop index
+
+    j = task_get_index(arg);
+
+    task_run_periodic(j, lat_body, NULL);
+
+    n_lat = task_get_lat_count(j);
+    for (k = 0; k < n_lat; k++)
+        lat[k] = task_get_lat_value(j, k);
+
+    return NULL;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    RUN_CASE:   Run lat_task with n_loads load threads, and report its
+                wake-up latencies as the case cas.
+                Return 0 in case of success, -1 otherwise
+_____________________________________________________________________________*/
+
+static int run_case(const char *cas, int n_loads)
+{
+    struct task_attr attr;
+    pthread_t        loads[MAX_LOADS];
+    int              j;  // task index
+    int              i;  // for-loop index
+    int              ret;
+
+    load_stop = 0;
+    for (i = 0; i < n_loads; i++)
+        if (pthread_create(&loads[i], NULL, load_thread, NULL) != 0) {
+            fprintf(stderr, "pthread_create failed\n");
+            return -1;
+        }
+
+    task_attr_init(&attr);
+    attr.rt_store  = RT_STORE_RING;
+    attr.rt_cap    = activations;
+    attr.lat_store = 1;
+
+    j   = task_alloc();
+    ret = task_create_ex(lat_task, j, PERIOD, PERIOD, PRIO, &attr);
+    if (ret == 0)
+        task_wait_for_end(j);
+    else
+        fprintf(stderr, "task_create_ex failed (%d)\n", ret);
+
+    load_stop = 1;
+    for (i = 0; i < n_loads; i++)
+        pthread_join(loads[i], NULL);
+
+    if (ret != 0)
+        return -1;
+
+    bench_report(BENCH, cas, "loads", n_loads, "threads");
+    bench_report_hist(BENCH, cas, lat, n_lat, "ns");
+    bench_report_dist(BENCH, cas, lat, n_lat, "ns");
+
+    return 0;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    MAIN
+_____________________________________________________________________________*/
+
+int main(int argc, char *argv[])
+{
+    long n_cpus;  // number of online cores
+
+    activations = (argc > 1) ? strtoul(argv[1], NULL, 10) : ACTIVATIONS;
+    if (activations == 0)
+        activations = ACTIVATIONS;
+    n_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (n_cpus > MAX_LOADS)
+        n_cpus = MAX_LOADS;
+
+    lat = malloc(activations * sizeof(*lat));
+    if (!lat) {
+        perror("malloc failed!");
+        return EXIT_FAILURE;
+    }
+
+    bench_report_header();
+
+    if (run_case("idle", 0) < 0 || run_case("loaded", (int)n_cpus) < 0)
+        return EXIT_FAILURE;
+
+    free(lat);
+
+    return EXIT_SUCCESS;
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,125 @@
+//*****************************************************************************
+//************ BENCH_REPORT.C - Machine-readable benchmark output *************
+//************               Author: Livio Bisogni               **************
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Please read the attached `bench_report.h` file.
+_____________________________________________________________________________*/
+
+
+#include "bench_report.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    LOCAL CONSTANTS
+_____________________________________________________________________________*/
+#define HIST_BINS 40  // histogram bins: [0, 1), then [2^(b-1), 2^b)
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    BENCH_REPORT_HEADER:    Print the header row (once per results file)
+_____________________________________________________________________________*/
+
+void bench_report_header() { printf("bench,case,metric,value,unit\n"); }
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    BENCH_REPORT:   Print a result row
+_____________________________________________________________________________*/
+
+void bench_report(const char *bench, const char *cas, const char *metric,
+                  double value, const char *unit)
+{
+    printf("%s,%s,%s,%.2f,%s\n", bench, cas, metric, value, unit);
+    fflush(stdout);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    CMP_INT64:  Comparison function of qsort, for int64_t values
+_____________________________________________________________________________*/
+
+static int cmp_int64(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *)a;
+    int64_t y = *(const int64_t *)b;
+
+    return (x > y) - (x < y);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    BENCH_REPORT_DIST:  Sort the n values v, then print their count, min,
+                        mean, percentiles (50, 90, 99, 99.9) and max
+_____________________________________________________________________________*/
+
+void bench_report_dist(const char *bench, const char *cas, int64_t *v,
+                       size_t n, const char *unit)
+{
+    static const double pct[]  = {50, 90, 99, 99.9};
+    static const char  *name[] = {"p50", "p90", "p99", "p99.9"};
+    double              sum;  // sum of the values
+    size_t              k;    // rank of a percentile
+    size_t              i;    // for-loop index
+
+    if (n == 0)
+        return;
+
+    qsort(v, n, sizeof(*v), cmp_int64);
+
+    sum = 0;
+    for (i = 0; i < n; i++)
+        sum += v[i];
+
+    bench_report(bench, cas, "count", n, "samples");
+    bench_report(bench, cas, "min", v[0], unit);
+    bench_report(bench, cas, "mean", sum / n, unit);
+    for (i = 0; i < sizeof(pct) / sizeof(pct[0]); i++) {
+        k = (size_t)(pct[i] / 100 * n + 0.999999);  // nearest rank
+        k = k < 1 ? 1 : (k > n ? n : k);
+        bench_report(bench, cas, name[i], v[k - 1], unit);
+    }
+    bench_report(bench, cas, "max", v[n - 1], unit);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    BENCH_REPORT_HIST:  Print a histogram of the n (non-negative) values v,
+                        with power-of-two bins: the metric "lt_<x><unit>"
+                        counts the values in [x / 2, x). Empty bins are not
+                        printed
+_____________________________________________________________________________*/
+
+void bench_report_hist(const char *bench, const char *cas, const int64_t *v,
+                       size_t n, const char *unit)
+{
+    size_t count[HIST_BINS] = {0};  // number of values of each bin
+    char   metric[32];              // name of a bin
+    int    b;                       // bin index
+    size_t i;                       // for-loop index
+
+    for (i = 0; i < n; i++) {
+        b = 0;
+        while (b < HIST_BINS - 1 && v[i] >= ((int64_t)1 << b))
+            b++;
+        count[b]++;
+    }
+
+    for (b = 0; b < HIST_BINS; b++) {
+        if (count[b] == 0)
+            continue;
+        snprintf(metric, sizeof(metric), "lt_%lld%s", (long long)1 << b, unit);
+        bench_report(bench, cas, metric, count[b], "samples");
+    }
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,40 @@
+//*****************************************************************************
+//*********** BENCH_REPORT.H - Header file of bench_report.c *******************
+//***********               Author: Livio Bisogni              ****************
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Common output of the benchmarks: every result is printed on stdout as a
+    CSV row "bench,case,metric,value,unit", after a single header row, so
+    that the results of different versions can be compared line by line.
+_____________________________________________________________________________*/
+
+
+#ifndef BENCH_REPORT_H
+#define BENCH_REPORT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    FUNCTION PROTOTYPES
+_____________________________________________________________________________*/
+
+void bench_report_header();
+
+void bench_report(const char *bench, const char *cas, const char *metric,
+                  double value, const char *unit);
+
+void bench_report_dist(const char *bench, const char *cas, int64_t *v,
+                       size_t n, const char *unit);
+
+void bench_report_hist(const char *bench, const char *cas, const int64_t *v,
+                       size_t n, const char *unit);
+
+//-----------------------------------------------------------------------------
+
+
+#endif  // BENCH_REPORT_H
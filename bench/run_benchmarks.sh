@@ -0,0 +1,23 @@
+#!/bin/sh
+#******************************************************************************
+#********** RUN_BENCHMARKS.SH - Run the benchmarks into a single CSV **********
+#**********                 Author: Livio Bisogni                    **********
+#******************************************************************************
+
+# Usage: run_benchmarks.sh output.csv bench...
+# Run each benchmark (from the current directory) with its default arguments,
+# and concatenate their results in output.csv, keeping a single header row.
+
+out=$1
+shift
+
+printf "bench,case,metric,value,unit\n" > "$out"
+
+for bench in "$@"; do
+	echo "Running $bench..." >&2
+	./"$bench" > "$out.tmp" || { rm -f "$out.tmp"; exit 1; }
+	tail -n +2 "$out.tmp" >> "$out"
+done
+
+rm -f "$out.tmp"
+echo "Results written to $out" >&2
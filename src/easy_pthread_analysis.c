@@ -0,0 +1,191 @@
+//*****************************************************************************
+//******** EASY_PTHREAD_ANALYSIS.C - For easy schedulability analysis *********
+//********                 Author: Livio Bisogni                  *************
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Please read the attached `README.md` file.
+_____________________________________________________________________________*/
+
+
+#include "easy_pthread_analysis.h"
+#include <assert.h>
+#include <math.h>
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    ANALYSIS_UTIL:  Compute the total utilization factor of the n tasks in ts
+_____________________________________________________________________________*/
+
+double analysis_util(const struct analysis_task *ts, int n)
+{
+    double u;  // total utilization factor
+    int    i;  // for-loop index
+
+    u = 0;
+    for (i = 0; i < n; i++)
+        u += (double)ts[i].wcet / ts[i].per;
+
+    return u;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    ANALYSIS_LL_BOUND:  Compute the Liu & Layland utilization bound for n
+                        tasks, i.e., n * (2^(1/n) - 1)
+_____________________________________________________________________________*/
+
+double analysis_ll_bound(int n)
+{
+    if (n <= 0)
+        return 1;
+
+    return n * (pow(2, 1.0 / n) - 1);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    ANALYSIS_IS_RM: Return 1 if the n tasks in ts meet the assumptions of the
+                    utilization bounds, i.e., their priorities are rate
+                    monotonic (a shorter period always has a strictly higher
+                    priority) and no deadline is shorter than its period, 0
+                    otherwise
+_____________________________________________________________________________*/
+
+int analysis_is_rm(const struct analysis_task *ts, int n)
+{
+    int i;  // for-loop index
+    int k;  // for-loop index
+
+    for (i = 0; i < n; i++) {
+        if (ts[i].dl < ts[i].per)
+            return 0;
+        for (k = 0; k < n; k++)
+            if (ts[i].per < ts[k].per && ts[i].pri <= ts[k].pri)
+                return 0;
+    }
+
+    return 1;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    ANALYSIS_TEST_LL:   Liu & Layland sufficient test: return 1 if the total
+                        utilization of the n tasks in ts does not exceed the
+                        bound, 0 otherwise. It assumes rate monotonic
+                        priorities and deadlines equal to periods (see
+                        analysis_is_rm)
+_____________________________________________________________________________*/
+
+int analysis_test_ll(const struct analysis_task *ts, int n)
+{
+    return analysis_util(ts, n) <= analysis_ll_bound(n);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    ANALYSIS_TEST_HYPERBOLIC:   Hyperbolic bound sufficient test: return 1 if
+                                the product of (U_i + 1) over the n tasks in
+                                ts does not exceed 2, 0 otherwise. It has the
+                                same assumptions as analysis_test_ll, but it
+                                is less pessimistic
+_____________________________________________________________________________*/
+
+int analysis_test_hyperbolic(const struct analysis_task *ts, int n)
+{
+    double prod;  // product of (U_i + 1)
+    int    i;     // for-loop index
+
+    prod = 1;
+    for (i = 0; i < n; i++)
+        prod *= (double)ts[i].wcet / ts[i].per + 1;
+
+    return prod <= 2;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    ANALYSIS_RTA:   Response time analysis: compute the worst-case response
+                    time (wcrt) of each of the n tasks in ts, by iterating
+                        R = C_i + sum over hp(i) of ceil(R / T_k) * C_k
+                    until a fixed point, where hp(i) holds the tasks with a
+                    priority higher than or equal to (as their order is not
+                    known) the one of the i-th task. The iteration stops as
+                    soon as R exceeds min(D_i, T_i), since the result is
+                    exact only for constrained deadlines.
+                    Return 1 if every task meets its deadline, 0 otherwise
+_____________________________________________________________________________*/
+
+int analysis_rta(struct analysis_task *ts, int n)
+{
+    int64_t r;       // current response time                            [ns]
+    int64_t r_prev;  // previous response time                           [ns]
+    int64_t d;       // deadline, constrained to the period              [ns]
+    int     ok;      // 1 if all the tasks are schedulable so far
+    int     i;       // for-loop index
+    int     k;       // for-loop index
+
+    ok = 1;
+
+    for (i = 0; i < n; i++) {
+        assert(ts[i].per > 0);
+
+        d = ts[i].dl < ts[i].per ? ts[i].dl : ts[i].per;
+        r = ts[i].wcet;
+
+        do {
+            r_prev = r;
+            r      = ts[i].wcet;
+            for (k = 0; k < n; k++)
+                if (k != i && ts[k].pri >= ts[i].pri)
+                    r += ((r_prev + ts[k].per - 1) / ts[k].per) * ts[k].wcet;
+        } while (r != r_prev && r <= d);
+
+        ts[i].wcrt = r;
+        if (r > d)
+            ok = 0;
+    }
+
+    return ok;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    ANALYSIS_RUN:   Compute the worst-case response time of each of the n
+                    tasks in ts (see analysis_rta), then return 1 if they pass
+                    the given test (ANALYSIS_*), 0 otherwise. ANALYSIS_NONE
+                    always passes. The utilization bounds are only sufficient
+                    under their assumptions (see analysis_is_rm): otherwise,
+                    the response time analysis is used instead
+_____________________________________________________________________________*/
+
+int analysis_run(struct analysis_task *ts, int n, int test)
+{
+    int ok;  // result of the response time analysis
+
+    ok = analysis_rta(ts, n);
+
+    if ((test == ANALYSIS_LL || test == ANALYSIS_HYPERBOLIC) &&
+        !analysis_is_rm(ts, n))
+        return ok;
+
+    switch (test) {
+        case ANALYSIS_LL:
+            return analysis_test_ll(ts, n);
+        case ANALYSIS_HYPERBOLIC:
+            return analysis_test_hyperbolic(ts, n);
+        case ANALYSIS_RTA:
+            return ok;
+        default:
+            return 1;
+    }
+}
+//-----------------------------------------------------------------------------
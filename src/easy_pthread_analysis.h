@@ -0,0 +1,70 @@
+//*****************************************************************************
+//******* EASY_PTHREAD_ANALYSIS.H - Header file of easy_pthread_analysis.c ****
+//*******                   Author: Livio Bisogni                   ***********
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Please read the attached `README.md` file.
+_____________________________________________________________________________*/
+
+
+#ifndef EASY_PTHREAD_ANALYSIS_H
+#define EASY_PTHREAD_ANALYSIS_H
+
+#include <stdint.h>
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    GLOBAL CONSTANTS
+_____________________________________________________________________________*/
+#define ANALYSIS_NONE       0  // no schedulability test
+#define ANALYSIS_LL         1  // Liu & Layland utilization bound
+#define ANALYSIS_HYPERBOLIC 2  // hyperbolic bound (Bini, Buttazzo, Buttazzo)
+#define ANALYSIS_RTA        3  // exact response time analysis
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    STRUCTURES DEFINITION
+_____________________________________________________________________________*/
+
+//-----------------------------------------------------------------------------
+/* Task model */
+/* A periodic task scheduled by fixed priorities on a single CPU. The wcrt
+   field is filled by the analysis. */
+struct analysis_task
+{
+    int64_t per;   // period                                                [ns]
+    int64_t dl;    // relative deadline                                     [ns]
+    int64_t wcet;  // worst-case execution time                             [ns]
+    int     pri;   // priority (the higher, the more important)
+    int64_t wcrt;  /* worst-case response time, or a value greater than the
+                      deadline if it is missed                           [ns] */
+};
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    FUNCTION PROTOTYPES
+_____________________________________________________________________________*/
+
+double analysis_util(const struct analysis_task *ts, int n);
+
+double analysis_ll_bound(int n);
+
+int analysis_is_rm(const struct analysis_task *ts, int n);
+
+int analysis_test_ll(const struct analysis_task *ts, int n);
+
+int analysis_test_hyperbolic(const struct analysis_task *ts, int n);
+
+int analysis_rta(struct analysis_task *ts, int n);
+
+int analysis_run(struct analysis_task *ts, int n, int test);
+
+//-----------------------------------------------------------------------------
+
+
+#endif  // EASY_PTHREAD_ANALYSIS_H
@@ -0,0 +1,693 @@
+//*****************************************************************************
+//******** EASY_PTHREAD_DISPATCH.C - For easy periodic job dispatching ********
+//********                 Author: Livio Bisogni                  *************
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Please read the attached `README.md` file.
+_____________________________________________________________________________*/
+
+
+#include "easy_pthread_dispatch.h"
+#include "easy_pthread_sim.h"
+#include "easy_pthread_trace.h"
+#include <assert.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    LOCAL CONSTANTS
+_____________________________________________________________________________*/
+#define WHEEL_SIZE (1 << DISPATCH_WHEEL_BITS)  // number of slots per level
+#define WHEEL_MASK (WHEEL_SIZE - 1)            // slot index mask
+#define WHEEL_SPAN \
+    ((uint64_t)1 << (DISPATCH_WHEEL_BITS * DISPATCH_WHEEL_LEVELS))  // [ticks]
+
+#define JOB_IDLE    0  // waiting for its next release
+#define JOB_QUEUED  1  // released, waiting for a worker
+#define JOB_RUNNING 2  // being run by a worker
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    STRUCTURES DEFINITION
+_____________________________________________________________________________*/
+
+//-----------------------------------------------------------------------------
+/* Periodic job */
+/* Its statistics are kept by the task registry, under the same index. */
+struct dispatch_job
+{
+    int                   ind;       // task index of the job
+    void                (*fn)(int, void *);  // job function
+    void                 *arg;       // argument of the job function
+    int                   pri;       // priority (order in the ready queue)
+    int64_t               per;       // period                              [ns]
+    int64_t               dl_r;      // relative deadline                   [ns]
+    int                   exec_time; // 1 if the execution time is measured
+    int64_t               release;   // next release time, since t0         [ns]
+    int64_t               act;       // release time of the pending one     [ns]
+    uint64_t              expiry;    // tick of the next release
+    int                   state;     // JOB_IDLE, JOB_QUEUED or JOB_RUNNING
+    int                   removed;   // 1 once dispatch_remove is called
+    unsigned long         overruns;  /* releases skipped, as the previous
+                                        activation was still pending */
+    struct dispatch_job **slot;      // wheel slot holding the job, or NULL
+    struct dispatch_job  *prev;      // previous job in the same wheel slot
+    struct dispatch_job  *next;      // next job in the same wheel slot
+    struct dispatch_job  *ready_next;  // next job in the ready queue
+};
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    GLOBAL VARIABLES (definition)
+_____________________________________________________________________________*/
+/* Hierarchical timing wheel: the slot i of level l holds the jobs expiring
+   at a tick whose l-th group of DISPATCH_WHEEL_BITS bits is i, among the
+   next 2^(BITS * (l + 1)) ticks. Every time the lower levels wrap, the
+   current slot of the upper one is cascaded down, so that each tick only
+   looks at a single slot of level 0. Everything is protected by disp_lock. */
+static struct dispatch_job  *wheel[DISPATCH_WHEEL_LEVELS][WHEEL_SIZE];
+static struct dispatch_job **job_tab;  // job of each task index, or NULL
+static struct dispatch_job  *ready;    // ready queue, by decreasing priority
+static uint64_t              now_tick;  // current tick
+static int64_t               tick;      // tick length                     [ns]
+static struct timespec       t0;        // time of the tick 0
+static pthread_t             timer_tid;  // timer thread
+static int                   timer_ok;   // 1 if the timer thread started
+static pthread_t            *workers;    // worker threads
+static int                   n_started;  // number of started worker threads
+static int                   running;    // 1 while the dispatcher is started
+static int                   stopping;   // 1 when the threads must exit
+static pthread_mutex_t       disp_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t        disp_ready;  // a job is queued (or stopping)
+static pthread_cond_t        disp_idle;   // a removed job has completed
+static pthread_cond_t        disp_tick;   // timer sleep (CLOCK_MONOTONIC)
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    ELAPSED_NS: Return the time elapsed since t0, in [ns]
+_____________________________________________________________________________*/
+
+static int64_t elapsed_ns()
+{
+    struct timespec now;
+
+    time_now(&now);
+
+    return timespec2ns(now) - timespec2ns(t0);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    WHEEL_INSERT:   Put job in the wheel slot of its expiry tick, which is
+                    first raised to min_tick, if lower. A job expiring beyond
+                    the span of the wheel is put in the farthest slot, and it
+                    is inserted again when that slot is reached
+_____________________________________________________________________________*/
+
+static void wheel_insert(struct dispatch_job *job, uint64_t min_tick)
+{
+    uint64_t delta;  // ticks until the expiry
+    uint64_t at;     // tick the slot is chosen for
+    int      l;      // wheel level
+
+    if (job->expiry < min_tick)
+        job->expiry = min_tick;
+
+    delta = job->expiry - now_tick;
+    at    = job->expiry;
+    if (delta >= WHEEL_SPAN) {
+        delta = WHEEL_SPAN - 1;
+        at    = now_tick + delta;
+    }
+
+    for (l = 0; l < DISPATCH_WHEEL_LEVELS - 1; l++)
+        if (delta < ((uint64_t)1 << ((l + 1) * DISPATCH_WHEEL_BITS)))
+            break;
+
+    job->slot = &(wheel[l][(at >> (l * DISPATCH_WHEEL_BITS)) & WHEEL_MASK]);
+    job->prev = NULL;
+    job->next = *(job->slot);
+    if (job->next)
+        job->next->prev = job;
+    *(job->slot) = job;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    WHEEL_UNLINK:   Remove job from its wheel slot, if any
+_____________________________________________________________________________*/
+
+static void wheel_unlink(struct dispatch_job *job)
+{
+    if (!job->slot)
+        return;
+
+    if (job->prev)
+        job->prev->next = job->next;
+    else
+        *(job->slot) = job->next;
+    if (job->next)
+        job->next->prev = job->prev;
+
+    job->slot = NULL;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    WHEEL_DETACH:   Empty the slot pointed by slot, returning its jobs as a
+                    list (linked by next)
+_____________________________________________________________________________*/
+
+static struct dispatch_job *wheel_detach(struct dispatch_job **slot)
+{
+    struct dispatch_job *list;
+    struct dispatch_job *job;
+
+    list  = *slot;
+    *slot = NULL;
+    for (job = list; job; job = job->next)
+        job->slot = NULL;
+
+    return list;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    READY_PUSH: Append job to the ready queue, after the jobs with a higher or
+                equal priority, and wake up a worker
+_____________________________________________________________________________*/
+
+static void ready_push(struct dispatch_job *job)
+{
+    struct dispatch_job **p;
+
+    for (p = &ready; *p && (*p)->pri >= job->pri; p = &((*p)->ready_next))
+        ;
+    job->ready_next = *p;
+    *p              = job;
+
+    pthread_cond_signal(&disp_ready);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    READY_REMOVE:   Remove job from the ready queue
+_____________________________________________________________________________*/
+
+static void ready_remove(struct dispatch_job *job)
+{
+    struct dispatch_job **p;
+
+    for (p = &ready; *p; p = &((*p)->ready_next)) {
+        if (*p == job) {
+            *p = job->ready_next;
+            return;
+        }
+    }
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    JOB_RELEASE:    Release a new activation of job, unless the previous one
+                    is still queued or running (overrun: the release is
+                    skipped, and counted as a deadline miss, since it never
+                    runs), then schedule the next one
+_____________________________________________________________________________*/
+
+static void job_release(struct dispatch_job *job)
+{
+    if (job->state == JOB_IDLE) {
+        job->act   = job->release;
+        job->state = JOB_QUEUED;
+        ready_push(job);
+    } else {
+        job->overruns++;
+        task_add_deadline_miss(job->ind, 1);  // the worker may be writing
+    }
+
+    job->release += job->per;
+    job->expiry = (uint64_t)((job->release + tick - 1) / tick);
+    wheel_insert(job, now_tick + 1);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    WHEEL_ADVANCE:  Advance the wheel by one tick: cascade the upper levels
+                    whose lower ones wrapped, then release the jobs of the
+                    current slot of level 0
+_____________________________________________________________________________*/
+
+static void wheel_advance()
+{
+    struct dispatch_job *list;  // jobs of the slot being processed
+    struct dispatch_job *job;
+    int                  shift;  // bits below the current level
+    int                  l;      // wheel level
+
+    now_tick++;
+
+    for (l = 1; l < DISPATCH_WHEEL_LEVELS; l++) {
+        shift = l * DISPATCH_WHEEL_BITS;
+        if (now_tick & (((uint64_t)1 << shift) - 1))
+            break;
+        list = wheel_detach(&(wheel[l][(now_tick >> shift) & WHEEL_MASK]));
+        while (list) {
+            job  = list;
+            list = list->next;
+            wheel_insert(job, now_tick);
+        }
+    }
+
+    list = wheel_detach(&(wheel[0][now_tick & WHEEL_MASK]));
+    while (list) {
+        job  = list;
+        list = list->next;
+        if (job->expiry > now_tick)  // beyond the span of the wheel
+            wheel_insert(job, now_tick + 1);
+        else
+            job_release(job);
+    }
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    DISPATCH_TIMER: Body of the timer thread: sleep until the next tick, then
+                    advance the wheel (catching up, if late)
+_____________________________________________________________________________*/
+
+static void *dispatch_timer(void *arg)
+{
+    struct timespec next;    // time of the next tick
+    int64_t         target;  // tick reached by the current time
+
+    (void)arg;
+
+    pthread_mutex_lock(&disp_lock);
+
+    while (!stopping) {
+        next = ns2timespec(timespec2ns(t0) + (int64_t)(now_tick + 1) * tick);
+        pthread_cond_timedwait(&disp_tick, &disp_lock, &next);
+        if (stopping)
+            break;
+
+        target = elapsed_ns() / tick;
+        while (now_tick < (uint64_t)target)
+            wheel_advance();
+    }
+
+    pthread_mutex_unlock(&disp_lock);
+
+    return NULL;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    DISPATCH_WORKER:    Body of a worker thread: run the queued activations,
+                        highest priority first, and record their response
+                        time (from their nominal release time) and deadline
+                        misses in the statistics of the job (and in the
+                        trace, if the job is attached to it)
+_____________________________________________________________________________*/
+
+static void *dispatch_worker(void *arg)
+{
+    struct dispatch_job *job;
+    int64_t              start;  // start time, since t0                [ns]
+    int64_t              end;    // completion time, since t0           [ns]
+    int64_t              cpu;    // thread CPU time at the start        [ns]
+    int64_t              exec;   // execution time of the activation    [ns]
+    int                  miss;   // 1 if the deadline was missed
+
+    (void)arg;
+
+    pthread_mutex_lock(&disp_lock);
+
+    for (;;) {
+        while (!ready && !stopping)
+            pthread_cond_wait(&disp_ready, &disp_lock);
+        if (stopping)  // the pending activations are dropped
+            break;
+
+        job        = ready;
+        ready      = job->ready_next;
+        job->state = JOB_RUNNING;
+        pthread_mutex_unlock(&disp_lock);
+
+        start = elapsed_ns();
+        cpu   = job->exec_time ? time_thread_cpu_ns() : 0;
+        job->fn(job->ind, job->arg);
+        exec = job->exec_time ? time_thread_cpu_ns() - cpu : 0;
+        end  = elapsed_ns();
+
+        miss = end > job->act + job->dl_r;
+        task_stats_write_begin(job->ind);
+        if (miss)
+            task_add_deadline_miss(job->ind, 1);
+        task_update_stats_at(job->ind,
+                             (double)(end - job->act) / NSEC_PER_MSEC,
+                             timespec2ns(t0) + end);
+        if (job->exec_time)
+            task_update_exec(job->ind, exec);
+        task_stats_write_end(job->ind);
+        trace_record(job->ind, task_get_ex_tot(job->ind),
+                     timespec2ns(t0) + job->act, timespec2ns(t0) + start,
+                     timespec2ns(t0) + end, miss);
+
+        pthread_mutex_lock(&disp_lock);
+        job->state = JOB_IDLE;
+        if (job->removed)
+            pthread_cond_broadcast(&disp_idle);
+    }
+
+    pthread_mutex_unlock(&disp_lock);
+
+    return NULL;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    START_THREAD:   Create a SCHED_RR thread running fn, with priority pri
+_____________________________________________________________________________*/
+
+static int start_thread(pthread_t *tid, void *(*fn)(void *), int pri)
+{
+    pthread_attr_t     myatt;
+    struct sched_param mypar;
+    int                tret;
+
+    pthread_attr_init(&myatt);
+    pthread_attr_setinheritsched(&myatt, PTHREAD_EXPLICIT_SCHED);
+    pthread_attr_setschedpolicy(&myatt, SCHED_RR);
+    mypar.sched_priority = pri;
+    pthread_attr_setschedparam(&myatt, &mypar);
+
+    tret = pthread_create(tid, &myatt, fn, NULL);
+    pthread_attr_destroy(&myatt);
+
+    return tret;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    DISPATCH_START: Start the dispatcher, with a timer thread ticking every
+                    tick_ns [ns] (priority pri + 1) and a pool of n_workers
+                    worker threads (priority pri), all under SCHED_RR.
+                    Periodic jobs can then be added by dispatch_add.
+                    Return EBUSY if the dispatcher is already started,
+                    ENOTSUP in simulation mode (where the time is virtual, so
+                    the timer would never tick), or the error code of
+                    pthread_create
+_____________________________________________________________________________*/
+
+int dispatch_start(int n_workers, int pri, int64_t tick_ns)
+{
+    pthread_condattr_t cattr;
+    int                tret;
+    int                i;  // for-loop index
+
+    assert(n_workers > 0);
+    assert(pri >= 1);
+    assert(pri <= LINUX_MAX_PRIO);
+    assert(tick_ns > 0);
+
+    pthread_mutex_lock(&disp_lock);
+
+    if (running) {
+        pthread_mutex_unlock(&disp_lock);
+        return EBUSY;
+    }
+    if (sim_is_active()) {
+        pthread_mutex_unlock(&disp_lock);
+        return ENOTSUP;
+    }
+
+    if (!job_tab) {
+        job_tab = calloc(TASK_MAX, sizeof(*job_tab));
+        if (!job_tab) {
+            perror("Error allocating the dispatcher job table");
+            exit(EXIT_FAILURE);
+        }
+    }
+    workers = malloc(n_workers * sizeof(*workers));
+    if (!workers) {
+        perror("Error allocating the dispatcher workers");
+        exit(EXIT_FAILURE);
+    }
+
+    pthread_condattr_init(&cattr);
+    pthread_condattr_setclock(&cattr, CLOCK_MONOTONIC);
+    pthread_cond_init(&disp_tick, &cattr);
+    pthread_condattr_destroy(&cattr);
+    pthread_cond_init(&disp_ready, NULL);
+    pthread_cond_init(&disp_idle, NULL);
+
+    memset(wheel, 0, sizeof(wheel));
+    ready    = NULL;
+    now_tick = 0;
+    tick     = tick_ns;
+    stopping = 0;
+    running  = 1;
+    time_now(&t0);
+
+    n_started = 0;
+    tret      = start_thread(&timer_tid, dispatch_timer,
+                             pri < LINUX_MAX_PRIO ? pri + 1 : pri);
+    timer_ok  = (tret == 0);
+    for (i = 0; tret == 0 && i < n_workers; i++) {
+        tret = start_thread(&(workers[i]), dispatch_worker, pri);
+        if (tret == 0)
+            n_started++;
+    }
+
+    pthread_mutex_unlock(&disp_lock);
+
+    if (tret != 0)
+        dispatch_stop();
+
+    return tret;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    DISPATCH_ADD:   Add a periodic job, with index j, period per and relative
+                    deadline dl_r (both in [ns]): job(j, arg) is run by a
+                    worker at each release, starting from the next tick.
+                    Releases are rounded up to the next tick; higher priority
+                    (pri) jobs are run first, when the workers are busy.
+                    The job is registered as a task without its own thread
+                    (see task_create_job, with the attributes pointed by
+                    attr, or NULL), so that its statistics are available
+                    through the task functions (e.g., task_get_stats).
+                    A release is skipped (see dispatch_get_overruns) if the
+                    previous activation is still pending, and it counts as a
+                    deadline miss of the job.
+                    Return EINVAL if the dispatcher is not started, EBUSY if
+                    the j-th job already exists, or the error code of
+                    task_create_job
+_____________________________________________________________________________*/
+
+int dispatch_add(int j, void (*job)(int j, void *arg), void *arg, int64_t per,
+                 int64_t dl_r, int pri, const struct task_attr *attr)
+{
+    struct dispatch_job *djob;
+    int                  tret;
+
+    assert(j >= 0);
+    assert(j < TASK_MAX);
+    assert(per > 0);
+    assert(dl_r >= 0);
+
+    /* The job is created (which may allocate and touch its response time
+       store) without holding disp_lock, so as not to block the timer and
+       the workers meanwhile; it is destroyed if it cannot be added */
+    tret = task_create_job(j, per, dl_r, pri, attr);
+    if (tret != 0)
+        return tret;
+
+    djob = calloc(1, sizeof(*djob));
+    if (!djob) {
+        perror("Error allocating a dispatcher job");
+        exit(EXIT_FAILURE);
+    }
+    djob->ind       = j;
+    djob->fn        = job;
+    djob->arg       = arg;
+    djob->pri       = pri;
+    djob->per       = per;
+    djob->dl_r      = dl_r;
+    djob->exec_time = attr ? attr->exec_time : 1;
+    djob->state     = JOB_IDLE;
+
+    pthread_mutex_lock(&disp_lock);
+
+    if (!running || stopping || job_tab[j]) {
+        tret = (!running || stopping) ? EINVAL : EBUSY;
+        pthread_mutex_unlock(&disp_lock);
+        task_destroy_job(j);
+        free(djob);
+        return tret;
+    }
+
+    djob->release = elapsed_ns();
+    djob->expiry  = (uint64_t)((djob->release + tick - 1) / tick);
+    wheel_insert(djob, now_tick + 1);
+    job_tab[j] = djob;
+
+    pthread_mutex_unlock(&disp_lock);
+
+    return 0;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    DISPATCH_REMOVE:    Remove the j-th job, waiting for its running
+                        activation (if any) to complete; a queued one is
+                        dropped. Its index is then released (see
+                        task_destroy_job).
+                        Return EINVAL if the j-th job does not exist
+_____________________________________________________________________________*/
+
+int dispatch_remove(int j)
+{
+    struct dispatch_job *job;
+
+    assert(j >= 0);
+    assert(j < TASK_MAX);
+
+    pthread_mutex_lock(&disp_lock);
+
+    job = job_tab ? job_tab[j] : NULL;
+    if (!job || job->removed) {
+        pthread_mutex_unlock(&disp_lock);
+        return EINVAL;
+    }
+
+    job->removed = 1;
+    wheel_unlink(job);
+    if (job->state == JOB_QUEUED) {
+        ready_remove(job);
+        job->state = JOB_IDLE;
+    }
+    while (job->state == JOB_RUNNING)
+        pthread_cond_wait(&disp_idle, &disp_lock);
+    job_tab[j] = NULL;
+
+    pthread_mutex_unlock(&disp_lock);
+
+    task_destroy_job(j);
+    free(job);
+
+    return 0;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    DISPATCH_GET_OVERRUNS:  Get the number of releases of the j-th job skipped
+                            because its previous activation was still pending
+_____________________________________________________________________________*/
+
+unsigned long dispatch_get_overruns(int j)
+{
+    unsigned long overruns;
+
+    assert(j >= 0);
+    assert(j < TASK_MAX);
+
+    pthread_mutex_lock(&disp_lock);
+    overruns = (job_tab && job_tab[j]) ? job_tab[j]->overruns : 0;
+    pthread_mutex_unlock(&disp_lock);
+
+    return overruns;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    DISPATCH_IS_RUNNING:    Return 1 while the dispatcher is started, 0
+                            otherwise
+_____________________________________________________________________________*/
+
+int dispatch_is_running()
+{
+    int r;
+
+    pthread_mutex_lock(&disp_lock);
+    r = running;
+    pthread_mutex_unlock(&disp_lock);
+
+    return r;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    DISPATCH_STOP:  Stop the dispatcher: wait for the running activations to
+                    complete, join the threads and remove all the jobs
+_____________________________________________________________________________*/
+
+void dispatch_stop()
+{
+    struct dispatch_job *job;
+    int                  i;  // for-loop index
+
+    pthread_mutex_lock(&disp_lock);
+    if (!running || stopping) {
+        pthread_mutex_unlock(&disp_lock);
+        return;
+    }
+    stopping = 1;
+    pthread_cond_broadcast(&disp_ready);
+    pthread_cond_broadcast(&disp_tick);
+    pthread_mutex_unlock(&disp_lock);
+
+    if (timer_ok)
+        pthread_join(timer_tid, NULL);
+    for (i = 0; i < n_started; i++)
+        pthread_join(workers[i], NULL);
+
+    for (i = 0; i < TASK_MAX; i++) {
+        job = job_tab[i];
+        if (!job)
+            continue;
+        job_tab[i] = NULL;
+        task_destroy_job(i);
+        free(job);
+    }
+
+    pthread_mutex_lock(&disp_lock);
+    memset(wheel, 0, sizeof(wheel));
+    ready = NULL;
+    free(workers);
+    workers = NULL;
+    pthread_cond_destroy(&disp_tick);
+    pthread_cond_destroy(&disp_ready);
+    pthread_cond_destroy(&disp_idle);
+    running  = 0;
+    stopping = 0;
+    pthread_mutex_unlock(&disp_lock);
+}
+//-----------------------------------------------------------------------------
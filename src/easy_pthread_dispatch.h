@@ -0,0 +1,48 @@
+//*****************************************************************************
+//******* EASY_PTHREAD_DISPATCH.H - Header file of easy_pthread_dispatch.c ****
+//*******                   Author: Livio Bisogni                   ***********
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Please read the attached `README.md` file.
+_____________________________________________________________________________*/
+
+
+#ifndef EASY_PTHREAD_DISPATCH_H
+#define EASY_PTHREAD_DISPATCH_H
+
+#include "easy_pthread_task.h"
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    GLOBAL CONSTANTS
+_____________________________________________________________________________*/
+#define DISPATCH_WHEEL_BITS   8  // log2 of the number of slots per level
+#define DISPATCH_WHEEL_LEVELS 4  /* number of levels of the timing wheel: it
+                                    spans 2^(BITS * LEVELS) ticks */
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    FUNCTION PROTOTYPES
+_____________________________________________________________________________*/
+
+int dispatch_start(int n_workers, int pri, int64_t tick_ns);
+
+int dispatch_add(int j, void (*job)(int j, void *arg), void *arg, int64_t per,
+                 int64_t drel, int prio, const struct task_attr *attr);
+
+int dispatch_remove(int j);
+
+unsigned long dispatch_get_overruns(int j);
+
+void dispatch_stop();
+
+int dispatch_is_running();
+
+//-----------------------------------------------------------------------------
+
+
+#endif  // EASY_PTHREAD_DISPATCH_H
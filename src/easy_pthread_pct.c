@@ -0,0 +1,240 @@
+//*****************************************************************************
+//************ EASY_PTHREAD_PCT.C - Exact and streaming percentiles ***********
+//************               Author: Livio Bisogni                  ***********
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Please read the attached `README.md` file.
+_____________________________________________________________________________*/
+
+
+#include "easy_pthread_pct.h"
+#include <stdlib.h>
+#include <string.h>
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    LOCAL CONSTANTS
+_____________________________________________________________________________*/
+#define PCT_LINEAR (2 << PCT_SUB_BITS)  // values counted one per bucket
+#define PCT_MAX    (((int64_t)1 << PCT_MAX_BITS) - 1)  // highest value
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    PCT_RANK:   Return the (nearest) rank of the q-th percentile (q in
+                [0, 100]) among n sorted values, in {1, ..., n}: i.e., the
+                smallest rank k such that at least q% of the values are not
+                greater than the k-th one
+_____________________________________________________________________________*/
+
+unsigned long pct_rank(double q, unsigned long n)
+{
+    double        r;  // exact rank
+    unsigned long k;  // nearest rank
+
+    r = q / 100 * n;
+    k = (unsigned long)r;
+    if (k < r)
+        k++;
+
+    return k < 1 ? 1 : (k > n ? n : k);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    PCT_HIST_INIT:  Allocate and clear (touching all of its memory, so that
+                    no page fault is taken when counting) the histogram
+                    pointed by h.
+                    Return 0 in case of success, -1 otherwise
+_____________________________________________________________________________*/
+
+int pct_hist_init(struct pct_hist *h)
+{
+    h->n     = 0;
+    h->count = malloc(PCT_BUCKETS * sizeof(*(h->count)));
+    if (!h->count)
+        return -1;
+
+    memset(h->count, 0, PCT_BUCKETS * sizeof(*(h->count)));
+
+    return 0;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    PCT_HIST_FREE:  Free the histogram pointed by h (if any)
+_____________________________________________________________________________*/
+
+void pct_hist_free(struct pct_hist *h)
+{
+    free(h->count);
+    h->count = NULL;
+    h->n     = 0;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    PCT_HIST_ADD:   Count the value v (clamped to [0, 2^PCT_MAX_BITS - 1])
+                    in the histogram pointed by h, in O(1)
+_____________________________________________________________________________*/
+
+void pct_hist_add(struct pct_hist *h, int64_t v)
+{
+    int shift;  // log2 of the bucket width
+
+    if (v < 0)
+        v = 0;
+    if (v > PCT_MAX)
+        v = PCT_MAX;
+
+    if (v < PCT_LINEAR)
+        h->count[v]++;
+    else {
+        shift = 63 - __builtin_clzll(v) - PCT_SUB_BITS;
+        h->count[((int64_t)shift << PCT_SUB_BITS) + (v >> shift)]++;
+    }
+    h->n++;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    PCT_HIST_VALUE: Return the value of rank k (in {1, ..., h->n}) counted in
+                    the histogram pointed by h, i.e., the midpoint of its
+                    bucket: its relative error is at most 1 / 2^(PCT_SUB_BITS
+                    + 1). Return -1 if the histogram is empty
+_____________________________________________________________________________*/
+
+double pct_hist_value(const struct pct_hist *h, unsigned long k)
+{
+    unsigned long seen;   // values in the buckets before b
+    int64_t       b;      // bucket index
+    int           shift;  // log2 of the bucket width
+
+    if (!h->count || h->n == 0)
+        return -1;
+
+    seen = 0;
+    for (b = 0; b < PCT_BUCKETS - 1; b++) {
+        seen += h->count[b];
+        if (seen >= k)
+            break;
+    }
+
+    if (b < PCT_LINEAR)
+        return b;
+
+    shift = (int)(b >> PCT_SUB_BITS) - 1;
+
+    return (double)((b - ((int64_t)shift << PCT_SUB_BITS)) << shift) +
+           (double)(((int64_t)1 << shift) - 1) / 2;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    SELECT_RANK:    Partially reorder v[lo..hi] so that v[k] holds the value
+                    it would hold if they were sorted, with no greater value
+                    before it and no smaller value after it (quickselect,
+                    with median-of-three pivots: O(hi - lo) on average), and
+                    return v[k]
+_____________________________________________________________________________*/
+
+static double select_rank(double *v, long lo, long hi, long k)
+{
+    double pivot;
+    double tmp;
+    long   mid;
+    long   i, j;
+
+#define SWAP(a, b) (tmp = v[a], v[a] = v[b], v[b] = tmp)
+
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (v[mid] < v[lo])
+            SWAP(mid, lo);
+        if (v[hi] < v[lo])
+            SWAP(hi, lo);
+        if (v[hi] < v[mid])
+            SWAP(hi, mid);
+        pivot = v[mid];
+
+        /* Hoare partition: v[lo..j] <= pivot <= v[i..hi], and the values in
+           between (if any) are equal to pivot */
+        i = lo;
+        j = hi;
+        while (i <= j) {
+            while (v[i] < pivot)
+                i++;
+            while (v[j] > pivot)
+                j--;
+            if (i <= j) {
+                SWAP(i, j);
+                i++;
+                j--;
+            }
+        }
+
+        if (k <= j)
+            hi = j;
+        else if (k >= i)
+            lo = i;
+        else
+            break;
+    }
+
+#undef SWAP
+
+    return v[k];
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    PCT_SELECT: Compute the exact q[i]-th percentiles (q[i] in [0, 100]; see
+                pct_rank) of the n values v into out[i], for i in {0, ...,
+                n_q - 1}, without sorting v: the ranks are selected in
+                increasing order, each one in the values not smaller than the
+                previous one. v is reordered.
+                Return 0 in case of success, -1 otherwise
+_____________________________________________________________________________*/
+
+int pct_select(double *v, unsigned long n, const double *q, double *out,
+               int n_q)
+{
+    int  *order;  // indexes of q, by increasing rank
+    long  lo;     // first value not yet ordered
+    long  k;      // rank of the current percentile (0-based)
+    int   i, l;   // for-loop indexes
+
+    if (n == 0)
+        return -1;
+
+    order = malloc(n_q * sizeof(*order));
+    if (!order)
+        return -1;
+
+    for (i = 0; i < n_q; i++) {  // insertion sort (n_q is small)
+        for (l = i; l > 0 && q[order[l - 1]] > q[i]; l--)
+            order[l] = order[l - 1];
+        order[l] = i;
+    }
+
+    lo = 0;
+    for (i = 0; i < n_q; i++) {
+        k = (long)pct_rank(q[order[i]], n) - 1;
+        out[order[i]] = select_rank(v, lo < k ? lo : k, (long)n - 1, k);
+        lo = k + 1;
+    }
+
+    free(order);
+
+    return 0;
+}
+//-----------------------------------------------------------------------------
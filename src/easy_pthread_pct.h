@@ -0,0 +1,67 @@
+//*****************************************************************************
+//********** EASY_PTHREAD_PCT.H - Header file of easy_pthread_pct.c ***********
+//**********                 Author: Livio Bisogni                  ***********
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Please read the attached `README.md` file.
+_____________________________________________________________________________*/
+
+
+#ifndef EASY_PTHREAD_PCT_H
+#define EASY_PTHREAD_PCT_H
+
+#include <stdint.h>
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    GLOBAL CONSTANTS
+_____________________________________________________________________________*/
+#define PCT_SUB_BITS 7   // sub-buckets per power of two: 2^PCT_SUB_BITS
+#define PCT_MAX_BITS 44  // values up to 2^PCT_MAX_BITS - 1 (about 4.9 h in ns)
+#define PCT_BUCKETS                                                          \
+    (((PCT_MAX_BITS - PCT_SUB_BITS) << PCT_SUB_BITS) + (1 << PCT_SUB_BITS))
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    STRUCTURES DEFINITION
+_____________________________________________________________________________*/
+
+//-----------------------------------------------------------------------------
+/* Log-linear histogram */
+/* Counts non-negative integer values (e.g., nanoseconds) in buckets whose
+   width is 1 below 2^(PCT_SUB_BITS + 1), then doubles at each power of two,
+   each power of two being split in 2^PCT_SUB_BITS buckets: any value is
+   thus known within 1 / 2^PCT_SUB_BITS of itself, in constant memory. */
+struct pct_hist
+{
+    unsigned long *count;  // number of values of each bucket (NULL if unused)
+    unsigned long  n;      // number of values
+};
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    FUNCTION PROTOTYPES
+_____________________________________________________________________________*/
+
+unsigned long pct_rank(double q, unsigned long n);
+
+int pct_hist_init(struct pct_hist *h);
+
+void pct_hist_free(struct pct_hist *h);
+
+void pct_hist_add(struct pct_hist *h, int64_t v);
+
+double pct_hist_value(const struct pct_hist *h, unsigned long k);
+
+int pct_select(double *v, unsigned long n, const double *q, double *out,
+               int n_q);
+
+//-----------------------------------------------------------------------------
+
+
+#endif  // EASY_PTHREAD_PCT_H
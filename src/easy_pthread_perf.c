@@ -0,0 +1,197 @@
+//*****************************************************************************
+//*********** EASY_PTHREAD_PERF.C - Hardware performance counters *************
+//***********              Author: Livio Bisogni                   ************
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Please read the attached `README.md` file.
+_____________________________________________________________________________*/
+
+
+#include "easy_pthread_perf.h"
+#include <linux/perf_event.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    LOCAL CONSTANTS
+_____________________________________________________________________________*/
+#define BARRIER() __asm__ __volatile__("" ::: "memory")  // compiler barrier
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    GLOBAL VARIABLES (definition)
+_____________________________________________________________________________*/
+
+static const struct
+{
+    uint32_t type;    // PERF_TYPE_*
+    uint64_t config;  // PERF_COUNT_*
+} events[PERF_N] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+};
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    OPEN_EVENT: Open the e-th counter (PERF_*) on the calling thread, on any
+                CPU, counting in kernel space too if allowed (software
+                counters only).
+                Return its file descriptor, or -1 in case of error
+_____________________________________________________________________________*/
+
+static int open_event(int e)
+{
+    struct perf_event_attr attr;
+    int                    fd;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size           = sizeof(attr);
+    attr.type           = events[e].type;
+    attr.config         = events[e].config;
+    attr.exclude_hv     = 1;
+    attr.exclude_kernel = events[e].type == PERF_TYPE_HARDWARE;
+
+    fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1,
+                      PERF_FLAG_FD_CLOEXEC);
+    if (fd < 0 && !attr.exclude_kernel) {  // e.g., perf_event_paranoid > 1
+        attr.exclude_kernel = 1;
+        fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1,
+                          PERF_FLAG_FD_CLOEXEC);
+    }
+
+    return fd;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    PERF_OPEN:  Open the counters pointed by pc on the calling thread (only
+                its activity is counted, wherever it runs), and map the
+                hardware ones. The counters that cannot be opened are left
+                out.
+                Return the bit mask of the open counters (bit e for the
+                counter PERF_* e); 0 if none could be opened
+_____________________________________________________________________________*/
+
+unsigned perf_open(struct perf_ctr *pc)
+{
+    void *page;
+    int   e;     // for-loop index
+
+    pc->avail = 0;
+    for (e = 0; e < PERF_N; e++) {
+        pc->page[e] = NULL;
+        pc->fd[e]   = open_event(e);
+        if (pc->fd[e] < 0)
+            continue;
+        pc->avail |= 1U << e;
+
+        if (events[e].type != PERF_TYPE_HARDWARE)
+            continue;
+        page = mmap(NULL, sysconf(_SC_PAGESIZE), PROT_READ, MAP_SHARED,
+                    pc->fd[e], 0);
+        if (page != MAP_FAILED)
+            pc->page[e] = page;
+    }
+
+    return pc->avail;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    READ_MAPPED:    Read the counter mapped in page by rdpmc (x86 only), into
+                    val.
+                    Return 0 in case of success, -1 if rdpmc cannot be used
+                    (e.g., the counter is not scheduled on the CPU)
+_____________________________________________________________________________*/
+
+static int read_mapped(const struct perf_event_mmap_page *page, uint64_t *val)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    uint32_t seq;    // sequence counter of the page
+    uint32_t idx;    // hardware counter index, plus 1 (0 if not scheduled)
+    int64_t  pmc;    // hardware counter value (sign-extended)
+    int      shift;  // 64 minus the width of the counter
+
+    do {
+        seq = page->lock;
+        BARRIER();
+        idx = page->index;
+        if (!page->cap_user_rdpmc || idx == 0)
+            return -1;
+        shift = 64 - page->pmc_width;
+        pmc   = (int64_t)((uint64_t)__rdpmc(idx - 1) << shift) >> shift;
+        *val  = page->offset + pmc;
+        BARRIER();
+    } while (page->lock != seq);
+
+    return 0;
+#else
+    (void)page;
+    (void)val;
+
+    return -1;
+#endif
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    PERF_READ:  Read the counters pointed by pc into val[PERF_*] (0 for the
+                ones that are not open): the hardware ones by rdpmc, if
+                possible, the others by a system call. It must be called by
+                the thread that opened them
+_____________________________________________________________________________*/
+
+void perf_read(const struct perf_ctr *pc, uint64_t *val)
+{
+    int e;  // for-loop index
+
+    for (e = 0; e < PERF_N; e++) {
+        val[e] = 0;
+        if (!(pc->avail & (1U << e)))
+            continue;
+        if (pc->page[e] && read_mapped(pc->page[e], &val[e]) == 0)
+            continue;
+        if (read(pc->fd[e], &val[e], sizeof(val[e])) != sizeof(val[e]))
+            val[e] = 0;
+    }
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    PERF_CLOSE: Unmap and close the counters pointed by pc
+_____________________________________________________________________________*/
+
+void perf_close(struct perf_ctr *pc)
+{
+    int e;  // for-loop index
+
+    for (e = 0; e < PERF_N; e++) {
+        if (!(pc->avail & (1U << e)))
+            continue;
+        if (pc->page[e])
+            munmap(pc->page[e], sysconf(_SC_PAGESIZE));
+        close(pc->fd[e]);
+        pc->page[e] = NULL;
+        pc->fd[e]   = -1;
+    }
+    pc->avail = 0;
+}
+//-----------------------------------------------------------------------------
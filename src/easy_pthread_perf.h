@@ -0,0 +1,65 @@
+//*****************************************************************************
+//********** EASY_PTHREAD_PERF.H - Header file of easy_pthread_perf.c *********
+//**********                 Author: Livio Bisogni                  ***********
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Please read the attached `README.md` file.
+_____________________________________________________________________________*/
+
+
+#ifndef EASY_PTHREAD_PERF_H
+#define EASY_PTHREAD_PERF_H
+
+#include <stdint.h>
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    GLOBAL CONSTANTS
+_____________________________________________________________________________*/
+#define PERF_CYCLES       0  // CPU cycles (user space)
+#define PERF_INSTRUCTIONS 1  // retired instructions (user space)
+#define PERF_LLC_MISSES   2  // last-level cache misses (user space)
+#define PERF_CTX_SWITCHES 3  // context switches
+#define PERF_PAGE_FAULTS  4  // page faults
+#define PERF_N            5  // number of counters
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    STRUCTURES DEFINITION
+_____________________________________________________________________________*/
+
+struct perf_event_mmap_page;
+
+//-----------------------------------------------------------------------------
+/* Counters of a thread */
+/* Each counter (PERF_*) is opened on its own, so that the ones the kernel or
+   the hardware refuses (e.g., in a virtual machine, or because of
+   perf_event_paranoid) are just left out. The hardware counters are also
+   mapped, so that they can be read by rdpmc, with no system call. */
+struct perf_ctr
+{
+    int                          fd[PERF_N];    // file descriptors, or -1
+    struct perf_event_mmap_page *page[PERF_N];  // mapped pages, or NULL
+    unsigned                     avail;  // bit mask of the open counters
+};
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    FUNCTION PROTOTYPES
+_____________________________________________________________________________*/
+
+unsigned perf_open(struct perf_ctr *pc);
+
+void perf_read(const struct perf_ctr *pc, uint64_t *val);
+
+void perf_close(struct perf_ctr *pc);
+
+//-----------------------------------------------------------------------------
+
+
+#endif  // EASY_PTHREAD_PERF_H
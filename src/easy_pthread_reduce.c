@@ -0,0 +1,429 @@
+//*****************************************************************************
+//******** EASY_PTHREAD_REDUCE.C - Fused reductions over sample stores ********
+//********                  Author: Livio Bisogni                     *********
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Please read the attached `README.md` file.
+_____________________________________________________________________________*/
+
+
+#include "easy_pthread_reduce.h"
+#include <assert.h>
+#include <float.h>
+#include <pthread.h>
+#include <unistd.h>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    STRUCTURES DEFINITION
+_____________________________________________________________________________*/
+
+//-----------------------------------------------------------------------------
+/* Part of a split reduction */
+/* The samples [m, n) of the store s, reduced by a worker thread. */
+struct reduce_part
+{
+    const struct rt_store *s;      // store of the samples
+    unsigned long          m;      // first sample
+    unsigned long          n;      // last sample (excluded)
+    double                 shift;  // shift of the sums
+    struct rt_reduce       r;      // result
+};
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    FUNCTION PROTOTYPES
+_____________________________________________________________________________*/
+static void reduce_scalar(const double *v, unsigned long n, double shift,
+                          struct rt_reduce *r);
+#if defined(__x86_64__)
+static void reduce_sse2(const double *v, unsigned long n, double shift,
+                        struct rt_reduce *r);
+static void reduce_avx2(const double *v, unsigned long n, double shift,
+                        struct rt_reduce *r);
+#endif
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    GLOBAL VARIABLES (definition)
+_____________________________________________________________________________*/
+static void (*const kernels[])(const double *, unsigned long, double,
+                               struct rt_reduce *) = {
+    reduce_scalar,  // REDUCE_ISA_SCALAR
+#if defined(__x86_64__)
+    reduce_sse2,    // REDUCE_ISA_SSE2
+    reduce_avx2,    // REDUCE_ISA_AVX2
+#endif
+};
+
+static int reduce_isa     = -1;  // ISA in use (-1: not detected yet)
+static int reduce_threads = 1;   // threads of a large reduction
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    RT_REDUCE_INIT: Initialize the reduction pointed by r (no samples)
+_____________________________________________________________________________*/
+
+void rt_reduce_init(struct rt_reduce *r)
+{
+    r->n     = 0;
+    r->min   = DBL_MAX;
+    r->max   = -DBL_MAX;
+    r->sum   = 0;
+    r->sumsq = 0;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    RT_REDUCE_MERGE:    Add the samples of the reduction s to the reduction
+                        r (both taken around the same shift)
+_____________________________________________________________________________*/
+
+void rt_reduce_merge(struct rt_reduce *r, const struct rt_reduce *s)
+{
+    r->n += s->n;
+    if (s->min < r->min)
+        r->min = s->min;
+    if (s->max > r->max)
+        r->max = s->max;
+    r->sum += s->sum;
+    r->sumsq += s->sumsq;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    REDUCE_SCALAR:  Add the n samples v to the reduction r, one at a time
+_____________________________________________________________________________*/
+
+static void reduce_scalar(const double *v, unsigned long n, double shift,
+                          struct rt_reduce *r)
+{
+    unsigned long i;  // for-loop index
+    double        d;  // distance of a sample from shift
+
+    for (i = 0; i < n; i++) {
+        if (v[i] < r->min)
+            r->min = v[i];
+        if (v[i] > r->max)
+            r->max = v[i];
+        d = v[i] - shift;
+        r->sum += d;
+        r->sumsq += d * d;
+    }
+    r->n += n;
+}
+//-----------------------------------------------------------------------------
+
+
+#if defined(__x86_64__)
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    REDUCE_SSE2:    Add the n samples v to the reduction r, 4 at a time (two
+                    independent 128-bit accumulators, hiding the latency of
+                    the additions); the tail is left to reduce_scalar
+_____________________________________________________________________________*/
+
+__attribute__((target("sse2"))) static void
+reduce_sse2(const double *v, unsigned long n, double shift, struct rt_reduce *r)
+{
+    __m128d       vmin0, vmin1, vmax0, vmax1;  // partial min and max
+    __m128d       vsum0, vsum1, vsq0, vsq1;    // partial sums
+    __m128d       vs, x0, x1;                  // shift and samples
+    double        lane[2];                     // lanes of a vector
+    unsigned long i;                           // for-loop index
+
+    if (n < 4) {
+        reduce_scalar(v, n, shift, r);
+        return;
+    }
+
+    vs    = _mm_set1_pd(shift);
+    vmin0 = vmin1 = _mm_set1_pd(r->min);
+    vmax0 = vmax1 = _mm_set1_pd(r->max);
+    vsum0 = vsum1 = vsq0 = vsq1 = _mm_setzero_pd();
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        x0    = _mm_loadu_pd(v + i);
+        x1    = _mm_loadu_pd(v + i + 2);
+        vmin0 = _mm_min_pd(vmin0, x0);
+        vmin1 = _mm_min_pd(vmin1, x1);
+        vmax0 = _mm_max_pd(vmax0, x0);
+        vmax1 = _mm_max_pd(vmax1, x1);
+        x0    = _mm_sub_pd(x0, vs);
+        x1    = _mm_sub_pd(x1, vs);
+        vsum0 = _mm_add_pd(vsum0, x0);
+        vsum1 = _mm_add_pd(vsum1, x1);
+        vsq0  = _mm_add_pd(vsq0, _mm_mul_pd(x0, x0));
+        vsq1  = _mm_add_pd(vsq1, _mm_mul_pd(x1, x1));
+    }
+
+    _mm_storeu_pd(lane, _mm_min_pd(vmin0, vmin1));
+    r->min = lane[0] < lane[1] ? lane[0] : lane[1];
+    _mm_storeu_pd(lane, _mm_max_pd(vmax0, vmax1));
+    r->max = lane[0] > lane[1] ? lane[0] : lane[1];
+    _mm_storeu_pd(lane, _mm_add_pd(vsum0, vsum1));
+    r->sum += lane[0] + lane[1];
+    _mm_storeu_pd(lane, _mm_add_pd(vsq0, vsq1));
+    r->sumsq += lane[0] + lane[1];
+    r->n += i;
+
+    reduce_scalar(v + i, n - i, shift, r);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    REDUCE_AVX2:    Add the n samples v to the reduction r, 8 at a time (two
+                    independent 256-bit accumulators); the tail is left to
+                    reduce_scalar
+_____________________________________________________________________________*/
+
+__attribute__((target("avx2"))) static void
+reduce_avx2(const double *v, unsigned long n, double shift, struct rt_reduce *r)
+{
+    __m256d       vmin0, vmin1, vmax0, vmax1;  // partial min and max
+    __m256d       vsum0, vsum1, vsq0, vsq1;    // partial sums
+    __m256d       vs, x0, x1;                  // shift and samples
+    double        lane[4];                     // lanes of a vector
+    unsigned long i;                           // for-loop index
+    int           k;                           // for-loop index
+
+    if (n < 8) {
+        reduce_scalar(v, n, shift, r);
+        return;
+    }
+
+    vs    = _mm256_set1_pd(shift);
+    vmin0 = vmin1 = _mm256_set1_pd(r->min);
+    vmax0 = vmax1 = _mm256_set1_pd(r->max);
+    vsum0 = vsum1 = vsq0 = vsq1 = _mm256_setzero_pd();
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        x0    = _mm256_loadu_pd(v + i);
+        x1    = _mm256_loadu_pd(v + i + 4);
+        vmin0 = _mm256_min_pd(vmin0, x0);
+        vmin1 = _mm256_min_pd(vmin1, x1);
+        vmax0 = _mm256_max_pd(vmax0, x0);
+        vmax1 = _mm256_max_pd(vmax1, x1);
+        x0    = _mm256_sub_pd(x0, vs);
+        x1    = _mm256_sub_pd(x1, vs);
+        vsum0 = _mm256_add_pd(vsum0, x0);
+        vsum1 = _mm256_add_pd(vsum1, x1);
+        vsq0  = _mm256_add_pd(vsq0, _mm256_mul_pd(x0, x0));
+        vsq1  = _mm256_add_pd(vsq1, _mm256_mul_pd(x1, x1));
+    }
+
+    _mm256_storeu_pd(lane, _mm256_min_pd(vmin0, vmin1));
+    for (k = 0; k < 4; k++)
+        if (lane[k] < r->min)
+            r->min = lane[k];
+    _mm256_storeu_pd(lane, _mm256_max_pd(vmax0, vmax1));
+    for (k = 0; k < 4; k++)
+        if (lane[k] > r->max)
+            r->max = lane[k];
+    _mm256_storeu_pd(lane, _mm256_add_pd(vsum0, vsum1));
+    r->sum += (lane[0] + lane[1]) + (lane[2] + lane[3]);
+    _mm256_storeu_pd(lane, _mm256_add_pd(vsq0, vsq1));
+    r->sumsq += (lane[0] + lane[1]) + (lane[2] + lane[3]);
+    r->n += i;
+
+    reduce_scalar(v + i, n - i, shift, r);
+}
+//-----------------------------------------------------------------------------
+
+#endif  // __x86_64__
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    RT_REDUCE_GET_ISA:  Return the instruction set of the reductions
+                        (REDUCE_ISA_*): unless forced by rt_reduce_set_isa,
+                        the best one supported by the CPU, detected at the
+                        first call
+_____________________________________________________________________________*/
+
+int rt_reduce_get_isa()
+{
+    int isa;
+
+    isa = __atomic_load_n(&reduce_isa, __ATOMIC_RELAXED);
+    if (isa >= 0)
+        return isa;
+
+    isa = REDUCE_ISA_SCALAR;
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    isa = __builtin_cpu_supports("avx2") ? REDUCE_ISA_AVX2 : REDUCE_ISA_SSE2;
+#endif
+    __atomic_store_n(&reduce_isa, isa, __ATOMIC_RELAXED);
+
+    return isa;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    RT_REDUCE_SET_ISA:  Force the instruction set of the reductions to isa
+                        (REDUCE_ISA_*), lowered to the best one supported by
+                        the CPU; a negative isa restores the detection.
+                        Return the instruction set actually in use
+_____________________________________________________________________________*/
+
+int rt_reduce_set_isa(int isa)
+{
+    int best;  // best instruction set supported
+
+    __atomic_store_n(&reduce_isa, -1, __ATOMIC_RELAXED);
+    best = rt_reduce_get_isa();
+
+    if (isa >= 0 && isa < best)
+        __atomic_store_n(&reduce_isa, isa, __ATOMIC_RELAXED);
+
+    return rt_reduce_get_isa();
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    RT_REDUCE_GET_THREADS:  Return the number of threads a reduction of more
+                            than REDUCE_MT_MIN samples is split among
+_____________________________________________________________________________*/
+
+int rt_reduce_get_threads()
+{
+    return __atomic_load_n(&reduce_threads, __ATOMIC_RELAXED);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    RT_REDUCE_SET_THREADS:  Split the reductions of more than REDUCE_MT_MIN
+                            samples among n threads (including the calling
+                            one; at most REDUCE_MT_MAX): 1 (default) disables
+                            the split, 0 uses a thread per online core
+_____________________________________________________________________________*/
+
+void rt_reduce_set_threads(int n)
+{
+    assert(n >= 0);
+
+    if (n == 0)
+        n = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (n < 1)
+        n = 1;
+    if (n > REDUCE_MT_MAX)
+        n = REDUCE_MT_MAX;
+
+    __atomic_store_n(&reduce_threads, n, __ATOMIC_RELAXED);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    RT_REDUCE_ARRAY:    Add the n samples v to the reduction r, with the
+                        kernel of the instruction set in use
+_____________________________________________________________________________*/
+
+void rt_reduce_array(const double *v, unsigned long n, double shift,
+                     struct rt_reduce *r)
+{
+    kernels[rt_reduce_get_isa()](v, n, shift, r);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    REDUCE_RANGE:   Add the samples [m, n) of the store s (of doubles) to
+                    the reduction r, one contiguous run at a time; samples
+                    never allocated are skipped
+_____________________________________________________________________________*/
+
+static void reduce_range(const struct rt_store *s, unsigned long m,
+                         unsigned long n, double shift, struct rt_reduce *r)
+{
+    const double *v;    // current run of samples
+    unsigned long len;  // length of the current run of samples
+
+    for (; m < n; m += len) {
+        v = rt_store_span(s, m, n, &len);
+        if (v)
+            rt_reduce_array(v, len, shift, r);
+    }
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    REDUCE_WORKER:  Body of the threads of a split reduction
+_____________________________________________________________________________*/
+
+static void *reduce_worker(void *arg)
+{
+    struct reduce_part *p;
+
+    p = (struct reduce_part *)arg;
+    reduce_range(p->s, p->m, p->n, p->shift, &(p->r));
+
+    return NULL;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    RT_REDUCE_STORE:    Add the samples [m, n) of the store s (of doubles) to
+                        the reduction r. With more than REDUCE_MT_MIN samples
+                        and several threads (see rt_reduce_set_threads), the
+                        range is split into contiguous parts, reduced in
+                        parallel (the calling thread taking the first one),
+                        then merged in order
+_____________________________________________________________________________*/
+
+void rt_reduce_store(const struct rt_store *s, unsigned long m,
+                     unsigned long n, double shift, struct rt_reduce *r)
+{
+    struct reduce_part part[REDUCE_MT_MAX];  // parts of the range
+    pthread_t          tid[REDUCE_MT_MAX];   // threads of the parts
+    int                started[REDUCE_MT_MAX];
+    unsigned long      step;                 // samples per part
+    int                n_parts;              // number of parts
+    int                i;                    // for-loop index
+
+    if (m >= n)
+        return;
+
+    n_parts = rt_reduce_get_threads();
+    if (n - m <= REDUCE_MT_MIN || n_parts <= 1) {
+        reduce_range(s, m, n, shift, r);
+        return;
+    }
+
+    step = (n - m + n_parts - 1) / n_parts;
+    for (i = 0; i < n_parts; i++) {
+        part[i].s     = s;
+        part[i].m     = m + i * step;
+        part[i].n     = (i == n_parts - 1) ? n : m + (i + 1) * step;
+        part[i].shift = shift;
+        rt_reduce_init(&(part[i].r));
+        started[i] = i > 0 && pthread_create(&tid[i], NULL, reduce_worker,
+                                             &part[i]) == 0;
+    }
+
+    for (i = 0; i < n_parts; i++) {
+        if (started[i])
+            pthread_join(tid[i], NULL);
+        else
+            reduce_worker(&part[i]);  // first part, or thread not created
+        rt_reduce_merge(r, &(part[i].r));
+    }
+}
+//-----------------------------------------------------------------------------
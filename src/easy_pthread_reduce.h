@@ -0,0 +1,77 @@
+//*****************************************************************************
+//******** EASY_PTHREAD_REDUCE.H - Header file of easy_pthread_reduce.c *******
+//********                  Author: Livio Bisogni                     *********
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Please read the attached `README.md` file.
+_____________________________________________________________________________*/
+
+
+#ifndef EASY_PTHREAD_REDUCE_H
+#define EASY_PTHREAD_REDUCE_H
+
+#include "easy_pthread_store.h"
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    GLOBAL CONSTANTS
+_____________________________________________________________________________*/
+#define REDUCE_ISA_SCALAR 0  // portable C loop
+#define REDUCE_ISA_SSE2   1  // 128-bit vectors (x86-64)
+#define REDUCE_ISA_AVX2   2  // 256-bit vectors (x86-64, if supported)
+
+#define REDUCE_MT_MIN (1UL << 20)  // samples above which threads may be used
+#define REDUCE_MT_MAX 64           // highest number of threads
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    STRUCTURES DEFINITION
+_____________________________________________________________________________*/
+
+//-----------------------------------------------------------------------------
+/* Reduction of a set of samples */
+/* Minimum, maximum, sum and sum of squares of n samples x, computed in a
+   single (fused) pass. The sums are taken around a shift s, i.e., they hold
+   sum(x - s) and sum((x - s)^2), so that the squares can be centered on a
+   known mean without cancellation. */
+struct rt_reduce
+{
+    unsigned long n;      // number of samples
+    double        min;    // minimum sample
+    double        max;    // maximum sample
+    double        sum;    // sum of (x - shift)
+    double        sumsq;  // sum of (x - shift)^2
+};
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    FUNCTION PROTOTYPES
+_____________________________________________________________________________*/
+
+void rt_reduce_init(struct rt_reduce *r);
+
+void rt_reduce_merge(struct rt_reduce *r, const struct rt_reduce *s);
+
+void rt_reduce_array(const double *v, unsigned long n, double shift,
+                     struct rt_reduce *r);
+
+void rt_reduce_store(const struct rt_store *s, unsigned long m,
+                     unsigned long n, double shift, struct rt_reduce *r);
+
+int rt_reduce_get_isa();
+
+int rt_reduce_set_isa(int isa);
+
+int rt_reduce_get_threads();
+
+void rt_reduce_set_threads(int n);
+
+//-----------------------------------------------------------------------------
+
+
+#endif  // EASY_PTHREAD_REDUCE_H
@@ -0,0 +1,232 @@
+//*****************************************************************************
+//****** EASY_PTHREAD_SHM.C - For easy out-of-process statistics reading ******
+//******                   Author: Livio Bisogni                   ************
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Please read the attached `README.md` file.
+_____________________________________________________________________________*/
+
+
+#include "easy_pthread_shm.h"
+#include "easy_pthread_time.h"
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    LOCAL CONSTANTS
+_____________________________________________________________________________*/
+#define READ_TRIES 1000  // attempts of shm_stats_read before giving up
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    GLOBAL VARIABLES (definition)
+_____________________________________________________________________________*/
+static struct shm_stats_hdr  *seg;    // mapped segment, or NULL
+static struct shm_stats_slot *slots;  // slots of the segment
+static size_t                 seg_size;  // size of the segment         [byte]
+static char                   seg_name[NAME_MAX];  // name of the segment
+static pthread_mutex_t        shm_lock = PTHREAD_MUTEX_INITIALIZER;
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    SHM_STATS_OPEN: Create the shared-memory segment name (e.g., "/myapp",
+                    i.e., /dev/shm/myapp), with n_slots slots: the tasks
+                    with index lower than n_slots, created from now on,
+                    publish their statistics into it at each update.
+                    Return 0 in case of success, EBUSY if a segment is
+                    already open, ENAMETOOLONG if name is too long, or the
+                    error code of shm_open, ftruncate or mmap
+_____________________________________________________________________________*/
+
+int shm_stats_open(const char *name, int n_slots)
+{
+    struct timespec t;
+    void           *addr;  // mapping of the segment
+    int             fd;
+    int             err;
+    int             i;     // for-loop index
+
+    assert(name);
+    assert(n_slots > 0);
+    assert(n_slots <= TASK_MAX);
+
+    pthread_mutex_lock(&shm_lock);
+
+    if (seg) {
+        pthread_mutex_unlock(&shm_lock);
+        return EBUSY;
+    }
+    if (strlen(name) >= sizeof(seg_name)) {
+        pthread_mutex_unlock(&shm_lock);
+        return ENAMETOOLONG;
+    }
+
+    fd = shm_open(name, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        err = errno;
+        pthread_mutex_unlock(&shm_lock);
+        return err;
+    }
+
+    seg_size = sizeof(struct shm_stats_hdr) +
+               (size_t)n_slots * sizeof(struct shm_stats_slot);
+    addr = MAP_FAILED;
+    err  = 0;
+    if (ftruncate(fd, seg_size) < 0)
+        err = errno;
+    else {
+        addr = mmap(NULL, seg_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED)
+            err = errno;
+    }
+    close(fd);  // the mapping stays valid
+    if (err != 0) {
+        shm_unlink(name);
+        pthread_mutex_unlock(&shm_lock);
+        return err;
+    }
+
+    seg   = (struct shm_stats_hdr *)addr;
+    slots = (struct shm_stats_slot *)(seg + 1);
+    strcpy(seg_name, name);
+
+    for (i = 0; i < n_slots; i++)
+        slots[i].task = -1;
+    seg->version   = SHM_VERSION;
+    seg->slot_size = sizeof(struct shm_stats_slot);
+    seg->n_slots   = n_slots;
+    seg->pid       = getpid();
+    clock_gettime(CLOCK_REALTIME, &t);
+    seg->real_ns = timespec2ns(t);
+    __atomic_thread_fence(__ATOMIC_RELEASE);  // magic last: header complete
+    memcpy(seg->magic, SHM_MAGIC, sizeof(seg->magic));
+
+    pthread_mutex_unlock(&shm_lock);
+
+    return 0;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    SHM_STATS_SLOT: Return the slot of the j-th task, or NULL if no segment
+                    is open or it has no slot for j
+_____________________________________________________________________________*/
+
+struct shm_stats_slot *shm_stats_slot(int j)
+{
+    struct shm_stats_slot *slot;
+
+    assert(j < TASK_MAX);
+    assert(j >= 0);
+
+    pthread_mutex_lock(&shm_lock);
+    slot = (seg && (uint32_t)j < seg->n_slots) ? &(slots[j]) : NULL;
+    pthread_mutex_unlock(&shm_lock);
+
+    return slot;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    SHM_STATS_PUBLISH:  Copy the statistics pointed by val (but seq) into
+                        slot, as a single update for the readers. Only one
+                        thread at a time may publish into a slot. It never
+                        blocks, nor does any system call
+_____________________________________________________________________________*/
+
+void shm_stats_publish(struct shm_stats_slot *slot,
+                       const struct shm_stats_slot *val)
+{
+    uint32_t seq;  // sequence counter before the update
+
+    seq = slot->seq;
+    __atomic_store_n(&(slot->seq), seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    slot->task      = val->task;
+    slot->dm        = val->dm;
+    slot->reserved  = 0;
+    slot->per_ns    = val->per_ns;
+    slot->dl_ns     = val->dl_ns;
+    slot->ex_tot    = val->ex_tot;
+    slot->rt_min    = val->rt_min;
+    slot->rt_avg    = val->rt_avg;
+    slot->rt_max    = val->rt_max;
+    slot->rt_std    = val->rt_std;
+    slot->util_inst = val->util_inst;
+    slot->util_avg  = val->util_avg;
+
+    __atomic_store_n(&(slot->seq), seq + 2, __ATOMIC_RELEASE);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    SHM_STATS_READ: Copy a consistent snapshot of slot (possibly mapped by
+                    another process) into val. It is meant for the readers.
+                    Return 0 in case of success, or -1 if the slot kept
+                    changing during READ_TRIES attempts
+_____________________________________________________________________________*/
+
+int shm_stats_read(const struct shm_stats_slot *slot,
+                   struct shm_stats_slot *val)
+{
+    uint32_t seq_start;  // sequence counter before the copy
+    uint32_t seq_end;    // sequence counter after the copy
+    int      tries;      // for-loop index
+
+    for (tries = 0; tries < READ_TRIES; tries++) {
+        seq_start = __atomic_load_n(&(slot->seq), __ATOMIC_ACQUIRE);
+        if (seq_start & 1) {  // update in progress
+            sched_yield();
+            continue;
+        }
+
+        memcpy(val, (const void *)slot, sizeof(*val));
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        seq_end = __atomic_load_n(&(slot->seq), __ATOMIC_RELAXED);
+        if (seq_start == seq_end)
+            return 0;
+    }
+
+    return -1;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    SHM_STATS_CLOSE:    Unmap and remove the segment. The publishing tasks
+                        must have ended before
+_____________________________________________________________________________*/
+
+void shm_stats_close()
+{
+    pthread_mutex_lock(&shm_lock);
+
+    if (seg) {
+        munmap(seg, seg_size);
+        shm_unlink(seg_name);
+        seg   = NULL;
+        slots = NULL;
+    }
+
+    pthread_mutex_unlock(&shm_lock);
+}
+//-----------------------------------------------------------------------------
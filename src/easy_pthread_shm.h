@@ -0,0 +1,90 @@
+//*****************************************************************************
+//*********** EASY_PTHREAD_SHM.H - Header file of easy_pthread_shm.c **********
+//***********                 Author: Livio Bisogni                 ***********
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Please read the attached `README.md` file.
+_____________________________________________________________________________*/
+
+
+#ifndef EASY_PTHREAD_SHM_H
+#define EASY_PTHREAD_SHM_H
+
+#include "easy_pthread_task.h"
+#include <stdint.h>
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    GLOBAL CONSTANTS
+_____________________________________________________________________________*/
+#define SHM_MAGIC   "EPTSTATS"  // first 8 bytes of the segment
+#define SHM_VERSION 1           // version of the segment layout
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    STRUCTURES DEFINITION
+_____________________________________________________________________________*/
+
+//-----------------------------------------------------------------------------
+/* Segment header */
+/* The segment is made of this header, followed by n_slots slots. A reader
+   must check magic, version and slot_size before reading the slots. */
+struct shm_stats_hdr
+{
+    char     magic[8];   // SHM_MAGIC (not null-terminated)
+    uint32_t version;    // SHM_VERSION
+    uint32_t slot_size;  // size of a slot                                [byte]
+    uint32_t n_slots;    // number of slots (the j-th one is of the task j)
+    int32_t  pid;        // process publishing the statistics
+    int64_t  real_ns;    // CLOCK_REALTIME time of the segment creation   [ns]
+} CACHE_ALIGNED;
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+/* Statistics of a task */
+/* Written by the task thread only, under a sequence lock: a reader copies
+   the slot when seq is even, and retries if seq changed meanwhile. */
+struct shm_stats_slot
+{
+    uint32_t seq;        // sequence counter; odd while being updated
+    int32_t  task;       // task index, or -1 if the slot is not in use
+    int32_t  dm;         // number of deadline misses
+    int32_t  reserved;   // 0
+    int64_t  per_ns;     // period                                          [ns]
+    int64_t  dl_ns;      // relative deadline                               [ns]
+    uint64_t ex_tot;     // (current) total number of task execution
+    double   rt_min;     // minimum response time                           [ms]
+    double   rt_avg;     // average response time                           [ms]
+    double   rt_max;     // maximum response time                           [ms]
+    double   rt_std;     // standard deviation of the response time         [ms]
+    double   util_inst;  // instantaneous utilization factor
+    double   util_avg;   // average utilization factor
+} CACHE_ALIGNED;
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    FUNCTION PROTOTYPES
+_____________________________________________________________________________*/
+
+int shm_stats_open(const char *name, int n_slots);
+
+struct shm_stats_slot *shm_stats_slot(int j);
+
+void shm_stats_publish(struct shm_stats_slot *slot,
+                       const struct shm_stats_slot *val);
+
+int shm_stats_read(const struct shm_stats_slot *slot,
+                   struct shm_stats_slot *val);
+
+void shm_stats_close();
+
+//-----------------------------------------------------------------------------
+
+
+#endif  // EASY_PTHREAD_SHM_H
@@ -0,0 +1,521 @@
+//*****************************************************************************
+//*********** EASY_PTHREAD_SIM.C - Virtual-time simulation mode ***************
+//***********              Author: Livio Bisogni                   ************
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Please read the attached `README.md` file.
+_____________________________________________________________________________*/
+
+
+#include "easy_pthread_sim.h"
+#include "easy_pthread_dispatch.h"
+#include "easy_pthread_task.h"
+#include "easy_pthread_time.h"
+#include <assert.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    LOCAL CONSTANTS
+_____________________________________________________________________________*/
+#define SIM_RUN   0  // the thread runs, out of a job (e.g., just created)
+#define SIM_BODY  1  // the thread runs the body of a job
+#define SIM_READY 2  // the next job is (or will be) released; not started
+#define SIM_EXEC  3  // the body has run; its execution time is simulated
+#define SIM_DONE  4  // the thread has ended
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    STRUCTURES DEFINITION
+_____________________________________________________________________________*/
+
+//-----------------------------------------------------------------------------
+/* Simulated task */
+/* A job of the task is released at release: its body is run (in zero
+   virtual time) when the job is first scheduled, then its execution time is
+   consumed by the simulated CPU, possibly preempted by other jobs. */
+struct sim_task
+{
+    int            ind;        // task index
+    int            state;      // SIM_*
+    int            pri;        // priority (SIM_FP)
+    int64_t        exec;       // declared execution time              [ns]
+    int64_t        exec_next;  // execution time of the current job, or -1
+    int64_t        release;    // release time of the pending job        [ns]
+    int64_t        dl;         // absolute deadline of the pending job   [ns]
+    int64_t        left;       // execution time left to the pending job [ns]
+    int64_t        now;        // virtual time seen by the task thread   [ns]
+    pthread_cond_t go;         // signaled when the thread may run
+};
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    GLOBAL VARIABLES (definition)
+_____________________________________________________________________________*/
+
+static pthread_mutex_t   sim_lock = PTHREAD_MUTEX_INITIALIZER;
+static int               active;    // 1 in the simulation mode
+static int               policy;    // SIM_FP or SIM_EDF
+static int64_t           horizon;   // end of the simulation; 0 if none  [ns]
+static int               started;   // 1 once sim_start is called
+static int               finished;  // 1 once the horizon is reached
+static int64_t           vnow;      // virtual time                      [ns]
+static int               running;   // threads running (SIM_RUN, SIM_BODY)
+static struct sim_task **tab;       // task of each index, or NULL
+static int               tab_cap;   // number of entries of tab
+static int              *act;       // indexes of the registered tasks
+static int               n_act;     // number of registered tasks
+
+static __thread struct sim_task *self;  // task of the calling thread
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    SIM_CLOCK:  Virtual clock read by time_now: the time of the job of the
+                calling task thread (its start while its body runs, its
+                completion afterwards), or the global virtual time for the
+                other threads
+_____________________________________________________________________________*/
+
+static int64_t sim_clock()
+{
+    if (self)
+        return self->now;
+
+    return __atomic_load_n(&vnow, __ATOMIC_RELAXED);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    HIGHER: Return 1 if the job of the task pointed by a takes precedence
+            over the one of the task pointed by b (by priority or absolute
+            deadline, then by release time, then by task index), 0 otherwise
+_____________________________________________________________________________*/
+
+static int higher(const struct sim_task *a, const struct sim_task *b)
+{
+    if (policy == SIM_FP && a->pri != b->pri)
+        return a->pri > b->pri;
+    if (policy == SIM_EDF && a->dl != b->dl)
+        return a->dl < b->dl;
+    if (a->release != b->release)
+        return a->release < b->release;
+
+    return a->ind < b->ind;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    WAKE:   Let the thread of the task pointed by t run, in state, at the
+            current virtual time
+_____________________________________________________________________________*/
+
+static void wake(struct sim_task *t, int state)
+{
+    t->state = state;
+    t->now   = vnow;
+    running++;
+    pthread_cond_signal(&(t->go));
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    FINISH: End the simulation at the horizon, and wake all the waiting
+            threads (their sim_wait and sim_job_end return -1)
+_____________________________________________________________________________*/
+
+static void finish()
+{
+    struct sim_task *t;
+    int              i;  // for-loop index
+
+    finished = 1;
+    __atomic_store_n(&vnow, horizon, __ATOMIC_RELAXED);
+
+    for (i = 0; i < n_act; i++) {
+        t = tab[act[i]];
+        if (t->state == SIM_READY || t->state == SIM_EXEC) {
+            t->now = horizon;
+            pthread_cond_signal(&(t->go));
+        }
+    }
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    ADVANCE:    Discrete-event scheduler: if no task thread is running,
+                advance the virtual time, event by event (releases and
+                completions), giving the simulated CPU to the highest
+                priority released job, until either a job must run its body
+                (when first scheduled) or a job completes: its thread is
+                then woken, and the time is frozen again until it blocks.
+                The caller must hold sim_lock
+_____________________________________________________________________________*/
+
+static void advance()
+{
+    struct sim_task *t;
+    struct sim_task *best;  // job holding the CPU
+    int64_t          next;  // time of the next release                  [ns]
+    int64_t          at;    // time of the next event                    [ns]
+    int              i;     // for-loop index
+
+    if (!started || finished || running > 0)
+        return;
+
+    for (;;) {
+        best = NULL;
+        next = INT64_MAX;
+        for (i = 0; i < n_act; i++) {
+            t = tab[act[i]];
+            if (t->state == SIM_READY && t->release > vnow) {
+                if (t->release < next)
+                    next = t->release;
+                continue;
+            }
+            if ((t->state == SIM_READY || t->state == SIM_EXEC) &&
+                (!best || higher(t, best)))
+                best = t;
+        }
+
+        if (best && best->state == SIM_READY) {  // first scheduled: run it
+            wake(best, SIM_BODY);
+            return;
+        }
+
+        at = next;
+        if (best && vnow + best->left < at)
+            at = vnow + best->left;
+        if (at == INT64_MAX)  // no pending job
+            return;
+        if (horizon > 0 && at > horizon) {
+            finish();
+            return;
+        }
+
+        if (best)
+            best->left -= at - vnow;
+        __atomic_store_n(&vnow, at, __ATOMIC_RELAXED);
+
+        if (best && best->left == 0) {  // completed
+            wake(best, SIM_RUN);
+            return;
+        }
+    }
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    SIM_INIT:   Enter the simulation mode: the tasks created from now on
+                run on a single simulated CPU, scheduled by policy (SIM_FP
+                or SIM_EDF), and time_now reads the virtual time, starting
+                from 0, up to horizon_ns [ns] (0 for no horizon). It must be
+                called before creating any task (the live ones would not
+                be simulated), and not while the dispatcher is started
+                (its timer needs the real time).
+                Return EBUSY if already in the simulation mode, if any
+                task is live or if the dispatcher is started, 0 otherwise
+_____________________________________________________________________________*/
+
+int sim_init(int policy_in, int64_t horizon_ns)
+{
+    assert(policy_in == SIM_FP || policy_in == SIM_EDF);
+    assert(horizon_ns >= 0);
+
+    pthread_mutex_lock(&sim_lock);
+
+    if (active || task_get_count() > 0 || dispatch_is_running()) {
+        pthread_mutex_unlock(&sim_lock);
+        return EBUSY;
+    }
+
+    policy   = policy_in;
+    horizon  = horizon_ns;
+    started  = 0;
+    finished = 0;
+    running  = 0;
+    vnow     = 0;
+    active   = 1;
+    time_set_virtual(sim_clock);
+
+    pthread_mutex_unlock(&sim_lock);
+
+    return 0;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    SIM_START:  Start advancing the virtual time (once every task thread
+                created so far is waiting for its first job), so that all
+                the tasks created before are released together at time 0.
+                It is called by task_wait_for_end; it has no effect out of
+                the simulation mode, or if already started
+_____________________________________________________________________________*/
+
+void sim_start()
+{
+    if (!active)
+        return;
+
+    pthread_mutex_lock(&sim_lock);
+    started = 1;
+    advance();
+    pthread_mutex_unlock(&sim_lock);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    SIM_IS_ACTIVE:  Return 1 in the simulation mode, 0 otherwise
+_____________________________________________________________________________*/
+
+int sim_is_active() { return active; }
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    SIM_IS_FINISHED:    Return 1 once the simulation reached its horizon, 0
+                        otherwise
+_____________________________________________________________________________*/
+
+int sim_is_finished()
+{
+    int f;
+
+    pthread_mutex_lock(&sim_lock);
+    f = finished;
+    pthread_mutex_unlock(&sim_lock);
+
+    return f;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    SIM_NOW_NS: Return the virtual time of the simulated CPU [ns]
+_____________________________________________________________________________*/
+
+int64_t sim_now_ns() { return __atomic_load_n(&vnow, __ATOMIC_RELAXED); }
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    SIM_SET_EXEC:   Set the execution time of the current job of the j-th
+                    task to exec_ns [ns], instead of the declared one (e.g.,
+                    to simulate a data-dependent path). It must be called by
+                    the body of the job
+_____________________________________________________________________________*/
+
+void sim_set_exec(int j, int64_t exec_ns)
+{
+    assert(exec_ns >= 0);
+
+    if (!active)
+        return;
+
+    pthread_mutex_lock(&sim_lock);
+    if (j < tab_cap && tab[j])
+        tab[j]->exec_next = exec_ns;
+    pthread_mutex_unlock(&sim_lock);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    SIM_REGISTER:   Register the j-th task, whose thread is about to be
+                    created, with priority pri and declared execution time
+                    exec_ns [ns] per job (required, so that the simulation
+                    does not depend on the real CPU time). The virtual time
+                    is not advanced until its thread waits for its first job
+                    (see sim_wait). It has no effect out of the simulation
+                    mode
+_____________________________________________________________________________*/
+
+void sim_register(int j, int pri, int64_t exec_ns)
+{
+    struct sim_task **tab_new;  // resized tab
+    int              *act_new;  // resized act
+    struct sim_task  *t;
+    int               cap;      // new capacity
+    int               i;        // for-loop index
+
+    assert(exec_ns > 0);
+
+    if (!active)
+        return;
+
+    pthread_mutex_lock(&sim_lock);
+
+    if (j >= tab_cap) {
+        cap     = (j + 1) * 2;
+        tab_new = realloc(tab, cap * sizeof(*tab));
+        act_new = realloc(act, cap * sizeof(*act));
+        if (!tab_new || !act_new) {
+            perror("Error allocating the simulated tasks");
+            exit(EXIT_FAILURE);
+        }
+        for (i = tab_cap; i < cap; i++)
+            tab_new[i] = NULL;
+        tab     = tab_new;
+        act     = act_new;
+        tab_cap = cap;
+    }
+    if (!tab[j]) {
+        tab[j] = calloc(1, sizeof(*(tab[j])));
+        if (!tab[j]) {
+            perror("Error allocating a simulated task");
+            exit(EXIT_FAILURE);
+        }
+        pthread_cond_init(&(tab[j]->go), NULL);
+    }
+
+    t            = tab[j];
+    t->ind       = j;
+    t->state     = SIM_RUN;
+    t->pri       = pri;
+    t->exec      = exec_ns;
+    t->exec_next = -1;
+    t->now       = vnow;
+    act[n_act++] = j;
+    running++;
+
+    pthread_mutex_unlock(&sim_lock);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    SIM_UNREGISTER: Remove the j-th task from the simulation (e.g., when its
+                    thread ends), and let the others go on
+_____________________________________________________________________________*/
+
+void sim_unregister(int j)
+{
+    struct sim_task *t;
+    int              i;  // for-loop index
+
+    if (!active)
+        return;
+
+    pthread_mutex_lock(&sim_lock);
+
+    t = j < tab_cap ? tab[j] : NULL;
+    if (t && t->state != SIM_DONE) {
+        if (t->state == SIM_RUN || t->state == SIM_BODY)
+            running--;
+        t->state = SIM_DONE;
+        for (i = 0; i < n_act && act[i] != j; i++)
+            ;
+        act[i] = act[--n_act];
+        advance();
+    }
+    if (self == t)
+        self = NULL;
+
+    pthread_mutex_unlock(&sim_lock);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    SIM_WAIT:   Called by the thread of the j-th task instead of sleeping
+                until its next job, released at release [ns], with absolute
+                deadline deadline [ns]: block until the job is first
+                scheduled on the simulated CPU, then let its body run.
+                Return the start time of the job [ns], or -1 if the
+                simulation reached its horizon before, or if the j-th task
+                is not simulated (i.e., it has no thread)
+_____________________________________________________________________________*/
+
+int64_t sim_wait(int j, int64_t release, int64_t deadline)
+{
+    struct sim_task *t;
+    int64_t          start;  // start time of the job                   [ns]
+
+    pthread_mutex_lock(&sim_lock);
+
+    t = j < tab_cap ? tab[j] : NULL;
+    if (t)
+        self = t;
+    if (!t || finished) {
+        pthread_mutex_unlock(&sim_lock);
+        return -1;
+    }
+
+    if (t->state == SIM_RUN || t->state == SIM_BODY)
+        running--;
+    t->state   = SIM_READY;
+    t->release = release;
+    t->dl      = deadline;
+    advance();
+
+    while (t->state == SIM_READY && !finished)
+        pthread_cond_wait(&(t->go), &sim_lock);
+
+    start = t->state == SIM_BODY ? t->now : -1;
+
+    pthread_mutex_unlock(&sim_lock);
+
+    return start;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    SIM_JOB_END:    Called by the thread of the j-th task when the body of
+                    its current job returns (if any; otherwise, it has no
+                    effect): simulate the execution time of the job (the one
+                    set by sim_set_exec, else the declared one), and block
+                    until the job completes on the simulated CPU. Out of the
+                    simulation mode, it has no effect.
+                    Return 0 in case of success, -1 if the simulation
+                    reached its horizon before
+_____________________________________________________________________________*/
+
+int sim_job_end(int j)
+{
+    struct sim_task *t;
+    int              ret;
+
+    if (!active)
+        return 0;
+
+    pthread_mutex_lock(&sim_lock);
+
+    t = j < tab_cap ? tab[j] : NULL;
+    if (!t || t->state != SIM_BODY) {
+        ret = finished ? -1 : 0;
+        pthread_mutex_unlock(&sim_lock);
+        return ret;
+    }
+
+    t->left      = t->exec_next >= 0 ? t->exec_next : t->exec;
+    t->exec_next = -1;
+    t->state     = SIM_EXEC;
+    running--;
+    advance();
+
+    while (t->state == SIM_EXEC && !finished)
+        pthread_cond_wait(&(t->go), &sim_lock);
+
+    ret = t->state == SIM_RUN ? 0 : -1;
+
+    pthread_mutex_unlock(&sim_lock);
+
+    return ret;
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,54 @@
+//*****************************************************************************
+//*********** EASY_PTHREAD_SIM.H - Header file of easy_pthread_sim.c **********
+//***********                 Author: Livio Bisogni                 ***********
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Please read the attached `README.md` file.
+_____________________________________________________________________________*/
+
+
+#ifndef EASY_PTHREAD_SIM_H
+#define EASY_PTHREAD_SIM_H
+
+#include <stdint.h>
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    GLOBAL CONSTANTS
+_____________________________________________________________________________*/
+#define SIM_FP  0  // preemptive fixed priorities (the task priorities)
+#define SIM_EDF 1  // preemptive earliest deadline first
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    FUNCTION PROTOTYPES
+_____________________________________________________________________________*/
+
+int sim_init(int policy, int64_t horizon_ns);
+
+void sim_start();
+
+int sim_is_active();
+
+int sim_is_finished();
+
+int64_t sim_now_ns();
+
+void sim_set_exec(int j, int64_t exec_ns);
+
+void sim_register(int j, int pri, int64_t exec_ns);
+
+void sim_unregister(int j);
+
+int64_t sim_wait(int j, int64_t release, int64_t deadline);
+
+int sim_job_end(int j);
+
+//-----------------------------------------------------------------------------
+
+
+#endif  // EASY_PTHREAD_SIM_H
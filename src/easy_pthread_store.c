@@ -0,0 +1,329 @@
+//*****************************************************************************
+//************** EASY_PTHREAD_STORE.C - For easy sample storage ***************
+//**************             Author: Livio Bisogni              ***************
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Please read the attached `README.md` file.
+_____________________________________________________________________________*/
+
+
+#include "easy_pthread_store.h"
+#include <assert.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    LOCAL CONSTANTS
+_____________________________________________________________________________*/
+#define HUGEPAGE_SIZE (2UL << 20)  // (default) huge page size on x86-64 [byte]
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    RT_STORE_MAP:   Map size bytes for the store pointed by s and touch each of
+                    their pages, so that no page fault occurs afterwards.
+                    With the RT_STORE_HUGEPAGE flag, reserved huge pages are
+                    tried first, then transparent huge pages.
+                    The mapping is recorded in s->block and s->block_size
+_____________________________________________________________________________*/
+
+static void rt_store_map(struct rt_store *s, size_t size)
+{
+    void  *block;
+    size_t huge_size;  // size rounded up to a multiple of HUGEPAGE_SIZE
+
+    block = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+    if (s->flags & RT_STORE_HUGEPAGE) {
+        huge_size = (size + HUGEPAGE_SIZE - 1) & ~(HUGEPAGE_SIZE - 1);
+        block     = mmap(NULL, huge_size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (block != MAP_FAILED)
+            size = huge_size;
+    }
+#endif
+
+    if (block == MAP_FAILED) {
+        block = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (block == MAP_FAILED) {
+            perror("mmap failed!");
+            exit(EXIT_FAILURE);
+        }
+#ifdef MADV_HUGEPAGE
+        if (s->flags & RT_STORE_HUGEPAGE)
+            madvise(block, size, MADV_HUGEPAGE);
+#endif
+    }
+
+    memset(block, 0, size);  // write every page, to actually fault it in
+
+    s->block      = (char *)block;
+    s->block_size = size;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    RT_STORE_INIT:  Initialize the sample store pointed by s, holding up to cap
+                    samples of elem bytes each, according to the given mode
+                    (RT_STORE_NONE, RT_STORE_RING or RT_STORE_CHUNKED).
+                    Only the ring mode allocates its samples upfront; the
+                    chunked mode just allocates its (small) chunk table, each
+                    chunk being allocated on its own when first written (no
+                    address space is reserved for the others, so that a
+                    locked process memory does not back them).
+                    With the RT_STORE_PREFAULT flag (see flags), both modes
+                    allocate and touch all of their samples upfront.
+                    Return 0 in case of success, -1 otherwise
+_____________________________________________________________________________*/
+
+int rt_store_init(struct rt_store *s, int mode, size_t elem, unsigned long cap,
+                  int flags)
+{
+    unsigned long c;  // chunk index
+
+    assert(elem > 0);
+
+    memset(s, 0, sizeof(*s));
+    s->mode  = mode;
+    s->flags = flags;
+    s->elem  = elem;
+    s->cap   = cap;
+
+    switch (mode) {
+    case RT_STORE_NONE:
+        s->cap = 0;
+        break;
+    case RT_STORE_RING:
+        assert(cap > 0);
+        if (flags & RT_STORE_PREFAULT) {
+            rt_store_map(s, cap * elem);
+            s->ring = s->block;
+            break;
+        }
+        s->ring = (char *)malloc(cap * elem);
+        if (!s->ring) {
+            perror("malloc failed!");
+            exit(EXIT_FAILURE);
+        }
+        break;
+    case RT_STORE_CHUNKED:
+        assert(cap > 0);
+        s->n_chunks = (cap + RT_STORE_CHUNK_LEN - 1) / RT_STORE_CHUNK_LEN;
+        s->chunks   = (char **)calloc(s->n_chunks, sizeof(char *));
+        if (!s->chunks) {
+            perror("calloc failed!");
+            exit(EXIT_FAILURE);
+        }
+        if (flags & RT_STORE_PREFAULT) {
+            rt_store_map(s, s->n_chunks * RT_STORE_CHUNK_LEN * elem);
+            for (c = 0; c < s->n_chunks; c++)
+                s->chunks[c] = s->block + c * RT_STORE_CHUNK_LEN * elem;
+        }
+        break;
+    default:
+        return -1;
+    }
+
+    return 0;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    RT_STORE_FREE:  Release all the memory held by the sample store pointed by s
+_____________________________________________________________________________*/
+
+void rt_store_free(struct rt_store *s)
+{
+    unsigned long c;  // chunk index
+
+    if (s->block) {
+        munmap(s->block, s->block_size);
+    } else {
+        for (c = 0; c < s->n_chunks; c++)
+            free(s->chunks[c]);
+        free(s->ring);
+    }
+
+    free(s->chunks);
+    memset(s, 0, sizeof(*s));
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    RT_STORE_LIMIT: Return the highest number of samples that can be recorded
+                    in the store pointed by s. Only the chunked mode is bounded,
+                    since both the ring and the stats-only modes just drop
+                    (i.e., overwrite or ignore) the oldest samples
+_____________________________________________________________________________*/
+
+unsigned long rt_store_limit(const struct rt_store *s)
+{
+    if (s->mode == RT_STORE_CHUNKED)
+        return s->cap;
+
+    return ULONG_MAX;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    RT_STORE_SLOT:  Return a pointer to the (writable) m-th sample of the store
+                    pointed by s, allocating its chunk if needed.
+                    Return NULL if the sample cannot be stored
+_____________________________________________________________________________*/
+
+void *rt_store_slot(struct rt_store *s, unsigned long m)
+{
+    unsigned long c;  // chunk index
+
+    switch (s->mode) {
+    case RT_STORE_RING:
+        return s->ring + (m % s->cap) * s->elem;
+    case RT_STORE_CHUNKED:
+        if (m >= s->cap)
+            return NULL;
+        c = m / RT_STORE_CHUNK_LEN;
+        if (!s->chunks[c]) {
+            s->chunks[c] = (char *)calloc(RT_STORE_CHUNK_LEN, s->elem);
+            if (!s->chunks[c]) {
+                perror("calloc failed!");
+                exit(EXIT_FAILURE);
+            }
+        }
+        return s->chunks[c] + (m % RT_STORE_CHUNK_LEN) * s->elem;
+    default:
+        return NULL;
+    }
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    RT_STORE_PEEK:  Return a pointer to the (read-only) m-th sample of the store
+                    pointed by s, or NULL if it was never allocated.
+                    Note: in ring mode, the caller must check that the sample
+                    has not been overwritten yet (see rt_store_first)
+_____________________________________________________________________________*/
+
+const void *rt_store_peek(const struct rt_store *s, unsigned long m)
+{
+    unsigned long c;  // chunk index
+
+    switch (s->mode) {
+    case RT_STORE_RING:
+        return s->ring + (m % s->cap) * s->elem;
+    case RT_STORE_CHUNKED:
+        if (m >= s->cap)
+            return NULL;
+        c = m / RT_STORE_CHUNK_LEN;
+        if (!s->chunks[c])
+            return NULL;
+        return s->chunks[c] + (m % RT_STORE_CHUNK_LEN) * s->elem;
+    default:
+        return NULL;
+    }
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    RT_STORE_FIRST: Return the index of the oldest sample still retained by the
+                    store pointed by s, once n samples (i.e., {0, ..., n - 1})
+                    have been recorded. If it equals n, nothing is retained
+_____________________________________________________________________________*/
+
+unsigned long rt_store_first(const struct rt_store *s, unsigned long n)
+{
+    switch (s->mode) {
+    case RT_STORE_RING:
+        return (n > s->cap) ? n - s->cap : 0;
+    case RT_STORE_CHUNKED:
+        return 0;
+    default:
+        return n;
+    }
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    RT_STORE_SPAN:  Return a pointer to the longest run of contiguous samples
+                    starting from the m-th one and not exceeding the n-th one
+                    (excluded); its length is stored in len.
+                    If such samples were never allocated, return NULL: len
+                    then holds the number of samples to be skipped.
+                    Used to scan the store without a function call per sample
+_____________________________________________________________________________*/
+
+const void *rt_store_span(const struct rt_store *s, unsigned long m,
+                          unsigned long n, unsigned long *len)
+{
+    unsigned long off;  // offset of the m-th sample within its chunk/ring
+    unsigned long run;  // length of the contiguous run
+
+    assert(m < n);
+
+    switch (s->mode) {
+    case RT_STORE_RING:
+        off = m % s->cap;
+        run = s->cap - off;
+        *len = (n - m < run) ? n - m : run;
+        return s->ring + off * s->elem;
+    case RT_STORE_CHUNKED:
+        if (m >= s->cap) {
+            *len = n - m;
+            return NULL;
+        }
+        off  = m % RT_STORE_CHUNK_LEN;
+        run  = RT_STORE_CHUNK_LEN - off;
+        *len = (n - m < run) ? n - m : run;
+        if (!s->chunks[m / RT_STORE_CHUNK_LEN])
+            return NULL;
+        return s->chunks[m / RT_STORE_CHUNK_LEN] + off * s->elem;
+    default:
+        *len = n - m;
+        return NULL;
+    }
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    RT_STORE_FLAT:  Return the contiguous array of samples of the store
+                    pointed by s, i.e. the live storage itself (writes through
+                    it are seen by the store and vice versa, and it stays
+                    valid until the store is freed):
+                        * the ring, in ring mode (the m-th sample being at
+                          position m % cap)
+                        * the mapping holding all the chunks, in chunked mode
+                          with the RT_STORE_PREFAULT flag (samples never
+                          written are zero); NULL without it, since the
+                          chunks are then allocated on their own (use
+                          rt_store_peek or rt_store_span instead)
+                        * NULL, in stats-only mode
+_____________________________________________________________________________*/
+
+void *rt_store_flat(const struct rt_store *s)
+{
+    switch (s->mode) {
+    case RT_STORE_RING:
+        return s->ring;
+    case RT_STORE_CHUNKED:
+        return s->block;
+    default:
+        return NULL;
+    }
+}
+//-----------------------------------------------------------------------------
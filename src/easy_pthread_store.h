@@ -0,0 +1,86 @@
+//*****************************************************************************
+//********* EASY_PTHREAD_STORE.H - Header file of easy_pthread_store.c ********
+//*********                  Author: Livio Bisogni                   **********
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Please read the attached `README.md` file.
+_____________________________________________________________________________*/
+
+
+#ifndef EASY_PTHREAD_STORE_H
+#define EASY_PTHREAD_STORE_H
+
+#include <stddef.h>
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    GLOBAL CONSTANTS
+_____________________________________________________________________________*/
+#define RT_STORE_NONE      0     // statistics only, no sample is stored
+#define RT_STORE_RING      1     // fixed-capacity ring (last cap samples)
+#define RT_STORE_CHUNKED   2     // chunks allocated on demand, up to cap
+#define RT_STORE_CHUNK_LEN 4096  // number of samples per chunk
+
+#define RT_STORE_PREFAULT  0x1  // allocate and touch every sample upfront
+#define RT_STORE_HUGEPAGE  0x2  // back the samples with huge pages, if any
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    STRUCTURES DEFINITION
+_____________________________________________________________________________*/
+
+//-----------------------------------------------------------------------------
+/* Sample store */
+/* Holds the samples of a task (e.g., its response times), indexed by the
+   activation number m. Depending on the mode, nothing is allocated at all
+   (RT_STORE_NONE), a single ring of cap samples is allocated upfront
+   (RT_STORE_RING), or memory is allocated one chunk at a time, the first time
+   a sample falling in that chunk is written (RT_STORE_CHUNKED).
+   With the RT_STORE_PREFAULT flag, all the samples are instead allocated in a
+   single mapping, touched upfront, so that recording a sample never triggers
+   a page fault. */
+struct rt_store
+{
+    int            mode;      // storage mode; value in {RT_STORE_*}
+    int            flags;     // allocation flags (RT_STORE_PREFAULT, ...)
+    size_t         elem;      // size of a single sample                [byte]
+    unsigned long  cap;       // capacity                            [samples]
+    unsigned long  n_chunks;  // length of the chunk table (chunked mode)
+    char         **chunks;    // chunk table (chunked mode)
+    char          *ring;      // ring buffer (ring mode)
+    char          *block;     // mapping backing ring/chunks, if any
+    size_t         block_size;  // size of the mapping                  [byte]
+};
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    FUNCTION PROTOTYPES
+_____________________________________________________________________________*/
+
+int rt_store_init(struct rt_store *s, int mode, size_t elem, unsigned long cap,
+                  int flags);
+
+void rt_store_free(struct rt_store *s);
+
+unsigned long rt_store_limit(const struct rt_store *s);
+
+void *rt_store_slot(struct rt_store *s, unsigned long m);
+
+const void *rt_store_peek(const struct rt_store *s, unsigned long m);
+
+unsigned long rt_store_first(const struct rt_store *s, unsigned long n);
+
+const void *rt_store_span(const struct rt_store *s, unsigned long m,
+                          unsigned long n, unsigned long *len);
+
+void *rt_store_flat(const struct rt_store *s);
+
+//-----------------------------------------------------------------------------
+
+
+#endif  // EASY_PTHREAD_STORE_H
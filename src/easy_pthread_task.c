@@ -10,357 +10,2631 @@
 _____________________________________________________________________________*/
 
 
+#define _GNU_SOURCE  // pthread_getattr_np, RUSAGE_THREAD, CPU affinity
 #include "easy_pthread_task.h"
+#include "easy_pthread_reduce.h"
+#include "easy_pthread_shm.h"
+#include "easy_pthread_sim.h"
+#include "easy_pthread_trace.h"
+#include "easy_pthread_watchdog.h"
+#include <alloca.h>
 #include <assert.h>
+#include <errno.h>
 #include <float.h>
 #include <math.h>
 #include <pthread.h>
+#include <sched.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    LOCAL CONSTANTS
+_____________________________________________________________________________*/
+#define STACK_MARGIN 16384  /* stack bytes left untouched when pre-faulting the
+                               stack of a task                         [byte] */
+#define TASK_REG_BLOCK 64   // number of task pointers per registry block
+#define TASK_REG_DIR   (TASK_MAX / TASK_REG_BLOCK)  // number of registry blocks
+
+/* Task registry lookup: pointer to the task_par of the j-th task */
+#define TP(j) (reg_dir[(j) / TASK_REG_BLOCK][(j) % TASK_REG_BLOCK])
+
+#define STATS_SPIN 64  /* snapshot attempts before task_get_stats sleeps, to
+                          let a preempted writer complete its update */
+
+#define CPU_ISOLATED "/sys/devices/system/cpu/isolated"   // isolcpus= CPUs
+#define CPU_NOHZ     "/sys/devices/system/cpu/nohz_full"  // nohz_full= CPUs
+
+#define DL_RUNTIME_MIN 1024  // minimum SCHED_DEADLINE runtime accepted  [ns]
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    STRUCTURES DEFINITION
+_____________________________________________________________________________*/
+
+//-----------------------------------------------------------------------------
+/* Scheduling attributes of the sched_setattr system call (it has no libc
+   wrapper on older systems), as defined by the Linux ABI */
+struct dl_sched_attr
+{
+    uint32_t size;            // size of this structure                  [byte]
+    uint32_t sched_policy;    // scheduling policy (SCHED_*)
+    uint64_t sched_flags;     // SCHED_FLAG_* (none used)
+    int32_t  sched_nice;      // nice value (SCHED_OTHER, SCHED_BATCH)
+    uint32_t sched_priority;  // static priority (SCHED_FIFO, SCHED_RR)
+    uint64_t sched_runtime;   // runtime budget (SCHED_DEADLINE)          [ns]
+    uint64_t sched_deadline;  // relative deadline (SCHED_DEADLINE)       [ns]
+    uint64_t sched_period;    // period (SCHED_DEADLINE)                  [ns]
+};
+//-----------------------------------------------------------------------------
 
 
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
     GLOBAL VARIABLES (definition)
 _____________________________________________________________________________*/
-pthread_t       tid[NT];
-struct task_par tp[NT];
+/* Task registry: a directory of blocks of pointers to task_par, both
+   allocated on demand and never moved nor freed, so that the j-th task_par
+   can be looked up in O(1) without any lock, even while other tasks are
+   being created or destroyed. Released indexes are reused (free stack), and
+   the indexes of the live tasks are kept dense (live array) for aggregate
+   queries. The lock only serializes creation and destruction. */
+static struct task_par **reg_dir[TASK_REG_DIR];
+static int               reg_hwm;       // lowest index never handed out
+static int              *reg_free;      // stack of released indexes
+static int               reg_n_free;    // length of the stack
+static int               reg_cap_free;  // capacity of the stack
+static int              *reg_live;      // indexes of the live tasks
+static int               reg_n_live;    // number of live tasks
+static int               reg_cap_live;  // capacity of reg_live
+static pthread_mutex_t   reg_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static int mem_locked;  // 1 once the process memory has been locked
+
+/* Automatic placement (TASK_PLACE_AUTO): the candidate CPUs are the isolated
+   (isolcpus) and tickless (nohz_full) ones, if any, or else the ones the
+   process may run on; each task is pinned to the candidate running the
+   fewest auto-placed tasks. Protected by reg_lock. */
+static cpu_set_t place_cpus;               // candidate CPUs
+static int       place_ready;              // 1 once place_cpus is computed
+static int       place_load[CPU_SETSIZE];  // auto-placed tasks on each CPU
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    REG_GROW:   Make room for at least n integers in the array pointed by arr,
+                whose capacity is pointed by cap (doubling it)
+_____________________________________________________________________________*/
+
+static void reg_grow(int **arr, int *cap, int n)
+{
+    int new_cap;
+
+    if (n <= *cap)
+        return;
+
+    new_cap = (*cap > 0) ? 2 * *cap : TASK_REG_BLOCK;
+    while (new_cap < n)
+        new_cap *= 2;
+
+    *arr = (int *)realloc(*arr, new_cap * sizeof(int));
+    if (!*arr) {
+        perror("realloc failed!");
+        exit(EXIT_FAILURE);
+    }
+    *cap = new_cap;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    REG_SLOT:   Return the task_par of the j-th task, allocating it (and its
+                registry block) if needed. Must be called with reg_lock held.
+                Each task_par is allocated on its own cache lines
+_____________________________________________________________________________*/
+
+static struct task_par *reg_slot(int j)
+{
+    struct task_par **block;
+    struct task_par  *tpar;
+
+    block = reg_dir[j / TASK_REG_BLOCK];
+    if (!block) {
+        block = (struct task_par **)calloc(TASK_REG_BLOCK, sizeof(*block));
+        if (!block) {
+            perror("calloc failed!");
+            exit(EXIT_FAILURE);
+        }
+        reg_dir[j / TASK_REG_BLOCK] = block;
+    }
+
+    tpar = block[j % TASK_REG_BLOCK];
+    if (!tpar) {
+        // Cache-line-aligned, so that tasks do not share any cache line
+        if (posix_memalign((void **)&tpar, CACHE_LINE, sizeof(*tpar)) != 0) {
+            perror("posix_memalign failed!");
+            exit(EXIT_FAILURE);
+        }
+        memset(tpar, 0, sizeof(*tpar));
+        tpar->cpu_auto = -1;
+        block[j % TASK_REG_BLOCK] = tpar;
+    }
+
+    return tpar;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    REG_ADD_LIVE:   Add the j-th task to the live tasks.
+                    Return EBUSY if it is already live.
+                    Must be called with reg_lock held
+_____________________________________________________________________________*/
+
+static int reg_add_live(int j)
+{
+    struct task_par *tpar;
+
+    tpar = reg_slot(j);
+    if (tpar->live)
+        return EBUSY;
+
+    reg_grow(&reg_live, &reg_cap_live, reg_n_live + 1);
+    tpar->used     = 1;
+    tpar->live     = 1;
+    tpar->live_pos = reg_n_live;
+    reg_live[reg_n_live++] = j;
+
+    return 0;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    REG_RELEASE:    Remove the j-th task from the live tasks (if it is live)
+                    and make its index available again. Its task_par is kept,
+                    so that late readers never dereference freed memory
+_____________________________________________________________________________*/
+
+static void reg_release(int j)
+{
+    struct task_par *tpar;
+    int              last;  // index of the last live task
+
+    pthread_mutex_lock(&reg_lock);
+
+    tpar = reg_slot(j);
+    if (tpar->live) {
+        if (tpar->cpu_auto >= 0)
+            place_load[tpar->cpu_auto]--;
+        tpar->cpu_auto           = -1;
+        last                     = reg_live[--reg_n_live];
+        reg_live[tpar->live_pos] = last;
+        TP(last)->live_pos       = tpar->live_pos;
+        tpar->live               = 0;
+    }
+
+    tpar->used = 0;
+    if (!tpar->in_free) {
+        reg_grow(&reg_free, &reg_cap_free, reg_n_free + 1);
+        reg_free[reg_n_free++] = j;
+        tpar->in_free          = 1;
+    }
+
+    pthread_mutex_unlock(&reg_lock);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    READ_CPU_LIST:  Add to set the CPUs listed in the file at path, in the
+                    kernel cpulist format (e.g., "2-5,8"). Return the number
+                    of CPUs read (0 if the file is missing or empty)
+_____________________________________________________________________________*/
+
+static int read_cpu_list(const char *path, cpu_set_t *set)
+{
+    FILE *fp;
+    char  buf[1024];
+    char *p;
+    char *end;
+    long  first;  // first CPU of a range
+    long  last;   // last CPU of a range
+    long  c;      // for-loop index
+    int   n;
+
+    fp = fopen(path, "r");
+    if (!fp)
+        return 0;
+    p = fgets(buf, sizeof(buf), fp);
+    fclose(fp);
+    if (!p)
+        return 0;
+
+    n = 0;
+    for (;;) {
+        first = strtol(p, &end, 10);
+        if (end == p)  // no (more) CPUs, e.g. "(null)"
+            break;
+        last = first;
+        if (*end == '-') {
+            p    = end + 1;
+            last = strtol(p, &end, 10);
+            if (end == p)
+                break;
+        }
+        for (c = first; c <= last && c < CPU_SETSIZE; c++) {
+            if (c >= 0 && !CPU_ISSET(c, set)) {
+                CPU_SET(c, set);
+                n++;
+            }
+        }
+        if (*end != ',')
+            break;
+        p = end + 1;
+    }
+
+    return n;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    PLACE_PICK: Pick the CPU for an auto-placed task, among the ones in attr
+                (if any) or else among place_cpus, and account for it.
+                Return the CPU, or -1 if there is no candidate.
+                The caller must hold reg_lock
+_____________________________________________________________________________*/
+
+static int place_pick(const struct task_attr *attr)
+{
+    cpu_set_t cand;  // candidate CPUs
+    int       best;  // least loaded CPU so far
+    int       n;     // number of isolated or tickless CPUs
+    int       c;     // for-loop index
+
+    if (!place_ready) {
+        CPU_ZERO(&place_cpus);
+        n = read_cpu_list(CPU_ISOLATED, &place_cpus);
+        n += read_cpu_list(CPU_NOHZ, &place_cpus);
+        if (n == 0)
+            sched_getaffinity(0, sizeof(place_cpus), &place_cpus);
+        place_ready = 1;
+    }
+
+    if (attr->n_cpus > 0) {
+        CPU_ZERO(&cand);
+        for (c = 0; c < attr->n_cpus; c++)
+            CPU_SET(attr->cpus[c], &cand);
+    } else
+        cand = place_cpus;
+
+    best = -1;
+    for (c = 0; c < CPU_SETSIZE; c++) {
+        if (!CPU_ISSET(c, &cand))
+            continue;
+        if (best < 0 || place_load[c] < place_load[best])
+            best = c;
+    }
+
+    if (best >= 0)
+        place_load[best]++;
+
+    return best;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    ANALYZABLE: Return 1 if the j-th task can be analyzed as a periodic task
+                under fixed priorities (i.e., it has a period, and it does
+                not run under SCHED_DEADLINE, whose tasks are admitted by the
+                kernel; one that fell back to its fallback policy, or that
+                has not started yet, does interfere as a fixed priority one)
+_____________________________________________________________________________*/
+
+static int analyzable(int j)
+{
+    return TP(j)->per_ns > 0 &&
+           __atomic_load_n(&(TP(j)->policy), __ATOMIC_RELAXED) !=
+               SCHED_DEADLINE;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    ANALYZE_LIVE:   Run the given schedulability test (ANALYSIS_*) on the
+                    live tasks, and record the worst-case response time of
+                    each of them. Each CPU is analyzed on its own, with the
+                    tasks pinned to it; the tasks that are not pinned to a
+                    single CPU are analyzed together, as if they shared one
+                    (which is pessimistic). The WCET of a task is the
+                    declared one, if any, or else its observed one (the
+                    maximum execution time, if measured, or rt_max, which
+                    also counts the preemptions; 0 if it has not run yet),
+                    read without waiting for the task (a sample being
+                    recorded may be missed). If declared is 1 (admission),
+                    every task must have a declared WCET, since the observed
+                    one is not a bound.
+                    Return 1 if every CPU passes the test, 0 otherwise.
+                    The caller must hold reg_lock
+_____________________________________________________________________________*/
+
+static int analyze_live(int test, int declared)
+{
+    struct analysis_task *ts;      // tasks sharing the current CPU
+    int                  *idx;     // their indexes
+    char                 *done;    // 1 if the i-th live task is analyzed
+    double                rt_max;  // observed maximum response time     [ms]
+    int                   n;       // number of tasks sharing the current CPU
+    int                   ok;    // 1 if every CPU passed the test so far
+    int                   cpu;   // current CPU
+    int                   i;     // for-loop index
+    int                   k;     // for-loop index
+    int                   j;     // task index
+
+    ts   = malloc((reg_n_live + 1) * sizeof(*ts));
+    idx  = malloc((reg_n_live + 1) * sizeof(*idx));
+    done = calloc(reg_n_live + 1, 1);
+    if (!ts || !idx || !done) {
+        perror("Error allocating the schedulability analysis data");
+        exit(EXIT_FAILURE);
+    }
+
+    ok = 1;
+    for (i = 0; i < reg_n_live; i++) {
+        if (done[i])
+            continue;
+        cpu = TP(reg_live[i])->cpu_pin;
+        n   = 0;
+        for (k = i; k < reg_n_live; k++) {
+            j = reg_live[k];
+            if (done[k] || TP(j)->cpu_pin != cpu)
+                continue;
+            done[k] = 1;
+            if (!analyzable(j)) {
+                TP(j)->wcrt_ns = -1;
+                continue;
+            }
+            ts[n].per  = TP(j)->per_ns;
+            ts[n].dl   = TP(j)->dl_r_ns;
+            ts[n].wcet = TP(j)->wcet_ns;
+            ts[n].pri  = TP(j)->pri;
+            if (ts[n].wcet == 0 && declared)
+                ok = 0;
+            if (ts[n].wcet == 0 &&
+                __atomic_load_n(&(TP(j)->exec_n), __ATOMIC_RELAXED) > 0)
+                ts[n].wcet =
+                    __atomic_load_n(&(TP(j)->exec_max), __ATOMIC_RELAXED);
+            else if (ts[n].wcet == 0) {
+                __atomic_load(&(TP(j)->rt_max), &rt_max, __ATOMIC_RELAXED);
+                ts[n].wcet = (int64_t)(rt_max * NSEC_PER_MSEC);
+            }
+            idx[n++] = j;
+        }
+        if (!analysis_run(ts, n, test))
+            ok = 0;
+        for (k = 0; k < n; k++)
+            TP(idx[k])->wcrt_ns = ts[k].wcrt;
+    }
+
+    free(ts);
+    free(idx);
+    free(done);
+
+    return ok;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_ALLOC: Reserve an unused task index, to be passed to task_create
+                (so that indexes do not have to be coordinated by hand).
+                Released indexes (see task_wait_for_end) are reused first.
+                Return the index, or -1 if all the TASK_MAX ones are in use
+_____________________________________________________________________________*/
+
+int task_alloc()
+{
+    struct task_par *tpar;
+    int              j;  // task index
+    int              k;  // released task index
+
+    pthread_mutex_lock(&reg_lock);
+
+    j = -1;
+    while (reg_n_free > 0 && j < 0) {
+        k             = reg_free[--reg_n_free];
+        tpar          = TP(k);
+        tpar->in_free = 0;
+        if (!tpar->used)  // it may have been taken by task_create meanwhile
+            j = k;
+    }
+
+    while (j < 0 && reg_hwm < TASK_MAX) {
+        if (!reg_slot(reg_hwm)->used)
+            j = reg_hwm;
+        reg_hwm++;
+    }
+
+    if (j >= 0) {
+        tpar       = reg_slot(j);
+        tpar->ind  = j;
+        tpar->used = 1;
+    }
+
+    pthread_mutex_unlock(&reg_lock);
+
+    return j;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_COUNT: Return the number of live tasks
+_____________________________________________________________________________*/
+
+int task_get_count()
+{
+    int n;
+
+    pthread_mutex_lock(&reg_lock);
+    n = reg_n_live;
+    pthread_mutex_unlock(&reg_lock);
+
+    return n;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    GET_THREAD_PAGE_FAULTS: Return the number of (minor and major) page faults
+                            taken so far by the calling thread
+_____________________________________________________________________________*/
+
+static long get_thread_page_faults()
+{
+    struct rusage ru;
+
+    if (getrusage(RUSAGE_THREAD, &ru) < 0)
+        return 0;
+
+    return ru.ru_minflt + ru.ru_majflt;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    PREFAULT_STACK: Touch the whole stack of the calling thread (but for
+                    STACK_MARGIN bytes), so that its pages are already mapped
+                    when the task runs
+_____________________________________________________________________________*/
+
+static void prefault_stack()
+{
+    pthread_attr_t myatt;
+    void          *stack_addr;  // lowest address of the stack
+    size_t         stack_size;
+    size_t         free_size;   // bytes between stack_addr and here
+    char           here;
+    char          *buf;
+
+    if (pthread_getattr_np(pthread_self(), &myatt) != 0)
+        return;
+    pthread_attr_getstack(&myatt, &stack_addr, &stack_size);
+    pthread_attr_destroy(&myatt);
+
+    free_size = (size_t)(&here - (char *)stack_addr);
+    if (free_size <= STACK_MARGIN)
+        return;
+
+    buf = (char *)alloca(free_size - STACK_MARGIN);
+    memset(buf, 0, free_size - STACK_MARGIN);
+    __asm__ __volatile__("" : : "r"(buf) : "memory");  // keep the memset
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    SET_DEADLINE_POLICY:    Move the calling thread to SCHED_DEADLINE, with
+                            the runtime, relative deadline and period of tpar.
+                            Return 0 in case of success, or else the errno of
+                            sched_setattr (e.g., EPERM without privileges,
+                            EBUSY if the admission test of the kernel fails,
+                            ENOSYS if not supported), leaving the thread
+                            under its previous policy
+_____________________________________________________________________________*/
+
+static int set_deadline_policy(const struct task_par *tpar)
+{
+    struct dl_sched_attr sa;
+
+    memset(&sa, 0, sizeof(sa));
+    sa.size           = sizeof(sa);
+    sa.sched_policy   = SCHED_DEADLINE;
+    sa.sched_runtime  = (uint64_t)tpar->runtime_ns;
+    sa.sched_deadline = (uint64_t)tpar->dl_r_ns;
+    sa.sched_period   = (uint64_t)tpar->per_ns;
+
+    if (syscall(SYS_sched_setattr, 0, &sa, 0) < 0)
+        return errno;
+
+    return 0;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    SHM_PUBLISH:    Publish the statistics of the task pointed by tpar into
+                    its shared-memory slot (see shm_stats_open)
+_____________________________________________________________________________*/
+
+static void shm_publish(struct task_par *tpar)
+{
+    struct shm_stats_slot val;  // statistics to be published
+
+    val.task      = tpar->ind;
+    val.dm        = tpar->dm;
+    val.per_ns    = tpar->per_ns;
+    val.dl_ns     = tpar->dl_r_ns;
+    val.ex_tot    = tpar->ex_tot;
+    val.rt_min    = tpar->rt_min;
+    val.rt_avg    = tpar->rt_avg;
+    val.rt_max    = tpar->rt_max;
+    val.rt_std    = tpar->rt_std;
+    val.util_inst = tpar->util_inst;
+    val.util_avg  = tpar->util_avg;
+
+    shm_stats_publish(tpar->shm, &val);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    SHM_UNPUBLISH:  Mark the shared-memory slot of the task pointed by tpar,
+                    if any, as not in use, and detach the task from it
+_____________________________________________________________________________*/
+
+static void shm_unpublish(struct task_par *tpar)
+{
+    struct shm_stats_slot val;  // empty statistics
+
+    if (!tpar->shm)
+        return;
+
+    memset(&val, 0, sizeof(val));
+    val.task = -1;
+    shm_stats_publish(tpar->shm, &val);
+    tpar->shm = NULL;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    PERF_BEGIN: Read the counters of the task pointed by tpar (if any) at the
+                start of an activation
+_____________________________________________________________________________*/
+
+static void perf_begin(struct task_par *tpar)
+{
+    if (!tpar->perf_avail)
+        return;
+
+    perf_read(&(tpar->perf_ctr), tpar->perf_base);
+    tpar->perf_run = 1;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    PERF_END:   Read the counters of the task pointed by tpar (if any) at the
+                end of an activation, and record their increments as the
+                counts of the activation. It has no effect if no activation
+                is being counted (e.g., if already called)
+_____________________________________________________________________________*/
+
+static void perf_end(struct task_par *tpar)
+{
+    uint64_t now[PERF_N];  // counters at the activation end
+    uint64_t d;            // count of the activation
+    int      e;            // for-loop index
+
+    if (!tpar->perf_run)
+        return;
+
+    perf_read(&(tpar->perf_ctr), now);
+    tpar->perf_run = 0;
+
+    task_stats_write_begin(tpar->ind);
+
+    tpar->perf_n++;
+    for (e = 0; e < PERF_N; e++) {
+        d                  = now[e] - tpar->perf_base[e];
+        tpar->perf_last[e] = d;
+        if (d > tpar->perf_max[e])
+            tpar->perf_max[e] = d;
+        tpar->perf_mean[e] += ((double)d - tpar->perf_mean[e]) / tpar->perf_n;
+    }
+
+    task_stats_write_end(tpar->ind);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    WD_FIRE:    Called by the watchdog thread when the timer of the j-th
+                task expires: if the watched deadline is past and its job
+                has not ended yet, count the deadline miss (once: the job
+                will not count it again, see wd_end) and call the handler
+                of the task, if any
+_____________________________________________________________________________*/
+
+static void wd_fire(int j)
+{
+    struct task_par *tpar;
+    struct timespec  now;
+    int64_t          dl;   // watched deadline                             [ns]
+
+    tpar = TP(j);
+    dl   = __atomic_load_n(&(tpar->wd_dl), __ATOMIC_ACQUIRE);
+
+    clock_gettime(CLOCK_MONOTONIC, &now);  // the clock of the timer
+    if (dl <= 0 || timespec2ns(now) < dl)  // job ended, or timer re-armed
+        return;
+    if (!__atomic_compare_exchange_n(&(tpar->wd_dl), &dl, -dl, 0,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+        return;  // the job has just ended
+
+    __atomic_fetch_add(&(tpar->dm), 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&(tpar->wd_n), 1, __ATOMIC_RELAXED);
+
+    if (tpar->wd_handler)
+        tpar->wd_handler(j);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    WD_ARM:     Arm the watchdog of the task pointed by tpar (if any) at the
+                absolute deadline of its new activation
+_____________________________________________________________________________*/
+
+static void wd_arm(struct task_par *tpar)
+{
+    int64_t dl;  // absolute deadline                                      [ns]
+
+    if (tpar->wd_fd < 0)
+        return;
+
+    dl = timespec2ns(tpar->dl_a);
+    __atomic_store_n(&(tpar->wd_dl), dl, __ATOMIC_RELEASE);
+    wdog_arm(tpar->wd_fd, dl);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    WD_END:     Stop watching the deadline of the current activation of the
+                task pointed by tpar, ended at time end (read if NULL). If
+                the watchdog already caught its deadline miss, record by how
+                much the job overran its deadline.
+                Return 1 if the watchdog caught the miss, 0 otherwise
+_____________________________________________________________________________*/
+
+static int wd_end(struct task_par *tpar, const struct timespec *end)
+{
+    struct timespec t;
+    int64_t         dl;   // watched deadline, negated if caught           [ns]
+    int64_t         ovr;  // overrun                                       [ns]
+
+    if (tpar->wd_fd < 0)
+        return 0;
+
+    dl = __atomic_exchange_n(&(tpar->wd_dl), 0, __ATOMIC_ACQ_REL);
+    if (dl >= 0)
+        return 0;
+
+    if (!end) {
+        time_now(&t);
+        end = &t;
+    }
+    ovr = timespec2ns(*end) + dl;
+    if (ovr < 0)  // the time source lags behind the clock of the timer
+        ovr = 0;
+
+    task_stats_write_begin(tpar->ind);
+    tpar->wd_ovr_last = ovr;
+    if (ovr > tpar->wd_ovr_max)
+        tpar->wd_ovr_max = ovr;
+    task_stats_write_end(tpar->ind);
+
+    return 1;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_START: Entry point of every task thread: set the thread up, then run
+                the task function (tpar->body), passing it its task_par
+_____________________________________________________________________________*/
+
+static void *task_start(void *arg)
+{
+    struct task_par *tpar;
+    void            *ret;  // return value of the task function
+
+    tpar         = (struct task_par *)arg;
+    tpar->tid_os = (pid_t)syscall(SYS_gettid);
+    tpar->cpu    = sched_getcpu();
+
+    if (tpar->runtime_ns > 0 && set_deadline_policy(tpar) == 0)
+        __atomic_store_n(&(tpar->policy), SCHED_DEADLINE, __ATOMIC_RELAXED);
+
+    if (tpar->rt_mem)
+        prefault_stack();
+    tpar->pf_base = get_thread_page_faults();
+
+    if (tpar->perf)
+        tpar->perf_avail = perf_open(&(tpar->perf_ctr));
+    if (tpar->watchdog && !sim_is_active())  // no real deadlines
+        tpar->wd_fd = wdog_add(tpar->ind, wd_fire);
+
+    ret = tpar->body(arg);
+    sim_unregister(tpar->ind);
+
+    if (tpar->perf)
+        perf_close(&(tpar->perf_ctr));  // the statistics are kept
+    if (tpar->wd_fd >= 0) {
+        wdog_remove(tpar->wd_fd);
+        tpar->wd_fd = -1;
+    }
+
+    tpar->pf_end  = get_thread_page_faults();
+    tpar->pf_done = 1;
+
+    return ret;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_ATTR_INIT: Initialize the task attributes pointed by attr to their
+                    default values, i.e., the ones used by task_create:
+                        * response times stored in chunks allocated on demand,
+                          up to GOOGOL samples
+                        * no memory locking nor pre-faulting ("RT memory"
+                          mode off), hence no huge pages
+                        * default stack size
+                        * no CPU affinity (the task may run on any CPU)
+                        * SCHED_RR policy
+                        * no declared WCET, and no admission test
+                        * wake-up latencies not stored (statistics only)
+                        * overrun activations caught up (TASK_OVERRUN_CATCHUP)
+                        * activations not traced
+                        * no response time histogram (exact percentiles only)
+                        * no sliding window (win_len = 0); if win_len > 0,
+                          the window holds the last win_len activations, and
+                          only the ones ending in the last win_ns [ns] if
+                          win_ns > 0
+                        * execution times measured (thread CPU clock)
+                        * no performance counters
+                        * no deadline watchdog, nor handler
+_____________________________________________________________________________*/
+
+void task_attr_init(struct task_attr *attr)
+{
+    attr->rt_store   = RT_STORE_CHUNKED;
+    attr->rt_cap     = GOOGOL;
+    attr->rt_mem     = 0;
+    attr->hugepages  = 0;
+    attr->stack_size = 0;
+    attr->cpus       = NULL;
+    attr->n_cpus     = 0;
+    attr->placement  = TASK_PLACE_NONE;
+    attr->policy     = SCHED_RR;
+    attr->fallback   = SCHED_RR;
+    attr->runtime_ns = 0;
+    attr->wcet_ns    = 0;
+    attr->admission  = ANALYSIS_NONE;
+    attr->lat_store  = 0;
+    attr->overrun    = TASK_OVERRUN_CATCHUP;
+    attr->trace      = 0;
+    attr->rt_hist    = 0;
+    attr->win_len    = 0;
+    attr->win_ns     = 0;
+    attr->exec_time  = 1;
+    attr->perf       = 0;
+    attr->watchdog   = 0;
+    attr->wd_handler = NULL;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_CREATE:    Create a task with a given period (per, expressed in [ms]),
+                    relative deadline (dl_r; expressed in [ms]) and priority
+                    (pri; value in {1, ..., LINUX_MAX_PRIO}).
+                    The task index (j) is decided by the user, or reserved
+                    by task_alloc. The user must guarantee that:
+                        * the index is in {0, ..., TASK_MAX - 1}
+                    Return EBUSY if the j-th task is already live
+_____________________________________________________________________________*/
+
+int task_create(void *(*task)(void *), int j, int per, int dl_r, int pri)
+{
+    return task_create_ex(task, j, per, dl_r, pri, NULL);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_CREATE_EX: Same as task_create, with the optional attributes pointed
+                    by attr (NULL means default attributes; see task_attr_init)
+_____________________________________________________________________________*/
+
+int task_create_ex(void *(*task)(void *), int j, int per, int dl_r, int pri,
+                   const struct task_attr *attr)
+{
+    assert(per >= 0);
+    assert(dl_r >= 0);
+
+    return task_create_ns(task, j, per * NSEC_PER_MSEC, dl_r * NSEC_PER_MSEC,
+                          pri, attr);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_CREATE_UNDO:   Undo the creation of the j-th task (with attributes
+                        attr), failed after its registration: free what
+                        task_create_common set up so far and release its
+                        index
+_____________________________________________________________________________*/
+
+static void task_create_undo(int j, const struct task_attr *attr)
+{
+    rt_store_free(&(TP(j)->rt_values));
+    rt_store_free(&(TP(j)->rt_indexes));
+    rt_store_free(&(TP(j)->lat_values));
+    pct_hist_free(&(TP(j)->rt_hist));
+    rt_window_free(&(TP(j)->win));
+    if (attr->trace)
+        trace_detach(j);
+    shm_unpublish(TP(j));
+    reg_release(j);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_CREATE_COMMON: Register the j-th task and, if thread is 1, create
+                        its thread (see task_create_ns and task_create_job)
+_____________________________________________________________________________*/
+
+static int task_create_common(void *(*task)(void *), int j, int64_t per,
+                              int64_t dl_r, int pri,
+                              const struct task_attr *attr, int thread)
+{
+    pthread_attr_t     myatt;
+    struct sched_param mypar;
+    struct task_attr   defatt;  // default task attributes
+    cpu_set_t          cpus;    // CPU affinity of the task
+    int                flags;   // response time store flags
+    int                cpu;     // auto-placed CPU
+    int                c;       // for-loop index
+    int                tret;
+
+    assert(j < TASK_MAX);
+    assert(j >= 0);
+    assert(per >= 0);
+    assert(dl_r >= 0);
+    assert(pri >= 0);
+    assert(pri <= LINUX_MAX_PRIO);
+
+    if (!attr) {
+        task_attr_init(&defatt);
+        attr = &defatt;
+    }
+
+    if (attr->n_cpus < 0 || (attr->n_cpus > 0 && !attr->cpus))
+        return EINVAL;
+    if (attr->policy != SCHED_RR && attr->policy != SCHED_FIFO &&
+        attr->policy != SCHED_DEADLINE)
+        return EINVAL;
+    if (attr->policy == SCHED_DEADLINE) {
+        if (attr->fallback != SCHED_RR && attr->fallback != SCHED_FIFO)
+            return EINVAL;
+        if (attr->runtime_ns < DL_RUNTIME_MIN || attr->runtime_ns > dl_r ||
+            dl_r > per)
+            return EINVAL;
+    }
+    if (attr->admission < ANALYSIS_NONE || attr->admission > ANALYSIS_RTA ||
+        (attr->admission != ANALYSIS_NONE && attr->wcet_ns <= 0))
+        return EINVAL;
+    if (attr->wcet_ns < 0 || (thread && sim_is_active() && !attr->wcet_ns))
+        return EINVAL;  // the simulation needs a declared execution time
+    if (attr->overrun < TASK_OVERRUN_CATCHUP ||
+        attr->overrun > TASK_OVERRUN_REPHASE)
+        return EINVAL;
+    if (attr->win_ns < 0 || (attr->win_ns > 0 && attr->win_len == 0))
+        return EINVAL;
+    CPU_ZERO(&cpus);
+    for (c = 0; c < attr->n_cpus; c++) {
+        if (attr->cpus[c] < 0 || attr->cpus[c] >= CPU_SETSIZE)
+            return EINVAL;
+        CPU_SET(attr->cpus[c], &cpus);
+    }
+
+    /* Pages are only locked once faulted in (when supported), so that the
+       ones never touched (e.g., the stacks of later tasks beyond their
+       pre-faulted part) are not backed as well; the RT memory mode touches
+       everything it needs upfront anyway */
+    flags = 0;
+    if (attr->rt_mem) {
+        if (!mem_locked) {
+            tret = -1;
+#ifdef MCL_ONFAULT
+            tret = mlockall(MCL_CURRENT | MCL_FUTURE | MCL_ONFAULT);
+            if (tret < 0 && errno != EINVAL)  // EINVAL: kernel without it
+                return errno;
+#endif
+            if (tret < 0 && mlockall(MCL_CURRENT | MCL_FUTURE) < 0)
+                return errno;
+            mem_locked = 1;
+        }
+        flags |= RT_STORE_PREFAULT;
+        if (attr->hugepages)
+            flags |= RT_STORE_HUGEPAGE;
+    }
+
+    /* The parameters used by the schedulability analysis are set along with
+       the registration, so that the analysis never sees stale ones */
+    pthread_mutex_lock(&reg_lock);
+    tret = reg_add_live(j);
+    cpu  = -1;
+    if (tret == 0) {
+        if (attr->placement == TASK_PLACE_AUTO)
+            cpu = place_pick(attr);
+        TP(j)->cpu_auto = cpu;
+        TP(j)->cpu_pin  = cpu;
+        if (cpu < 0 && attr->n_cpus == 1)
+            TP(j)->cpu_pin = attr->cpus[0];
+        TP(j)->per_ns     = per;
+        TP(j)->dl_r_ns    = dl_r;
+        TP(j)->pri        = pri;
+        TP(j)->policy     = attr->policy;
+        TP(j)->runtime_ns = 0;
+        if (attr->policy == SCHED_DEADLINE) {
+            TP(j)->policy     = attr->fallback;
+            TP(j)->runtime_ns = attr->runtime_ns;
+        }
+        TP(j)->wcet_ns = attr->wcet_ns;
+        TP(j)->wcrt_ns = -1;
+        TP(j)->rt_max  = 0;
+        if (attr->admission != ANALYSIS_NONE &&
+            !analyze_live(attr->admission, 1))
+            tret = EAGAIN;
+    }
+    pthread_mutex_unlock(&reg_lock);
+    if (tret == EAGAIN)  // not admitted
+        reg_release(j);
+    if (tret != 0)
+        return tret;
+    if (attr->trace && trace_attach(j) != 0) {
+        reg_release(j);
+        return EINVAL;
+    }
+
+    TP(j)->ind     = j;
+    TP(j)->per     = (int)(per / NSEC_PER_MSEC);
+    TP(j)->dl_r    = (int)(dl_r / NSEC_PER_MSEC);
+    TP(j)->dm      = 0;
+    TP(j)->seq     = 0;
+    TP(j)->seq_depth = 0;
+    TP(j)->cpu     = -1;
+    TP(j)->migr    = 0;
+    TP(j)->skip    = 0;
+    TP(j)->lat_last  = 0;
+    TP(j)->lat_min   = INT64_MAX;
+    TP(j)->lat_max   = 0;
+    TP(j)->lat_n     = 0;
+    TP(j)->lat_mean  = 0;
+    TP(j)->lat_m2    = 0;
+    TP(j)->rt_avg  = 0;
+    TP(j)->rt_max  = 0;
+    TP(j)->rt_min  = DBL_MAX;  // max. finite representable floating-point number
+    TP(j)->rt_tot  = 0;
+    TP(j)->rt_std  = 0;
+    TP(j)->util_inst = 0;
+    TP(j)->util_avg  = 0;
+    TP(j)->ex_tot    = 0;
+    TP(j)->rt_last   = 0;
+    TP(j)->rt_n      = 0;
+    TP(j)->rt_mean   = 0;
+    TP(j)->rt_m2     = 0;
+    TP(j)->win_dm    = 0;
+    TP(j)->exec_n    = 0;
+    TP(j)->exec_last = 0;
+    TP(j)->exec_min  = INT64_MAX;
+    TP(j)->exec_max  = 0;
+    TP(j)->exec_mean = 0;
+    TP(j)->perf_avail = 0;
+    TP(j)->perf_run  = 0;
+    TP(j)->perf_n    = 0;
+    memset(TP(j)->perf_last, 0, sizeof(TP(j)->perf_last));
+    memset(TP(j)->perf_max, 0, sizeof(TP(j)->perf_max));
+    memset(TP(j)->perf_mean, 0, sizeof(TP(j)->perf_mean));
+    TP(j)->body      = task;
+    TP(j)->rt_mem    = attr->rt_mem;
+    TP(j)->tid_os    = 0;
+    TP(j)->pf_base   = 0;
+    TP(j)->pf_end    = 0;
+    TP(j)->pf_done   = 0;
+    TP(j)->stop      = 0;
+    TP(j)->overrun   = attr->overrun;
+    TP(j)->exec_time = attr->exec_time;
+    TP(j)->perf      = attr->perf && thread;
+    TP(j)->watchdog  = attr->watchdog && thread;
+    TP(j)->wd_handler = attr->wd_handler;
+    TP(j)->wd_fd     = -1;
+    TP(j)->wd_dl     = 0;
+    TP(j)->wd_n      = 0;
+    TP(j)->wd_ovr_last = 0;
+    TP(j)->wd_ovr_max  = 0;
+    TP(j)->shm       = shm_stats_slot(j);
+
+    /* The histogram and the window of the previous task are kept until now,
+       as statistics */
+    pct_hist_free(&(TP(j)->rt_hist));
+    rt_window_free(&(TP(j)->win));
+
+    if (rt_store_init(&(TP(j)->rt_values), attr->rt_store, sizeof(double),
+                      attr->rt_cap, flags) < 0 ||
+        rt_store_init(&(TP(j)->rt_indexes), attr->rt_store,
+                      sizeof(unsigned long), attr->rt_cap, flags) < 0 ||
+        rt_store_init(&(TP(j)->lat_values),
+                      attr->lat_store ? attr->rt_store : RT_STORE_NONE,
+                      sizeof(int64_t), attr->rt_cap, flags) < 0) {
+        task_create_undo(j, attr);
+        return EINVAL;
+    }
+
+    if (attr->rt_hist && pct_hist_init(&(TP(j)->rt_hist)) < 0) {
+        task_create_undo(j, attr);
+        return ENOMEM;
+    }
+    if (attr->win_len > 0 &&
+        rt_window_init(&(TP(j)->win), attr->win_len, attr->win_ns) < 0) {
+        task_create_undo(j, attr);
+        return ENOMEM;
+    }
+
+    /* Published only now, so that a failed creation leaves no phantom task
+       (the slot is marked as not in use again if pthread_create fails) */
+    if (TP(j)->shm)
+        shm_publish(TP(j));
+
+    if (!thread)
+        return 0;
+
+    sim_register(j, TP(j)->pri, TP(j)->wcet_ns);
+
+    pthread_attr_init(&myatt);
+    pthread_attr_setinheritsched(&myatt, PTHREAD_EXPLICIT_SCHED);
+    pthread_attr_setschedpolicy(&myatt, TP(j)->policy);
+    mypar.sched_priority = TP(j)->pri;
+    pthread_attr_setschedparam(&myatt, &mypar);
+    if (attr->stack_size > 0)
+        pthread_attr_setstacksize(&myatt, attr->stack_size);
+    if (cpu >= 0) {
+        CPU_ZERO(&cpus);
+        CPU_SET(cpu, &cpus);
+    }
+    if (cpu >= 0 || attr->n_cpus > 0)
+        pthread_attr_setaffinity_np(&myatt, sizeof(cpus), &cpus);
+
+    tret = pthread_create(&(TP(j)->tid), &myatt, task_start, (void *)TP(j));
+    pthread_attr_destroy(&myatt);
+
+    if (tret != 0) {
+        sim_unregister(j);
+        task_create_undo(j, attr);
+    }
+
+    return tret;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_CREATE_NS: Same as task_create_ex, with the period (per) and the
+                    relative deadline (dl_r) expressed in [ns], so that
+                    sub-millisecond ones can be used (e.g., 250 us is
+                    250 * NSEC_PER_USEC). In "RT memory" mode (attr->rt_mem),
+                    the whole process memory is locked (current and future),
+                    the response time store is entirely allocated and
+                    touched here and the task stack is touched before running
+                    the task, so that the periodic loop never page-faults:
+                    hence, a bounded rt_cap should be chosen.
+                    The thread affinity is set before the thread starts: to
+                    attr->cpus, or, with TASK_PLACE_AUTO, to a single CPU
+                    (see place_pick).
+                    With the SCHED_DEADLINE policy, the thread is created
+                    under the fallback policy (with priority pri), then it
+                    moves itself to SCHED_DEADLINE, with runtime
+                    attr->runtime_ns, deadline dl_r and period per, before
+                    running the task function. If the kernel refuses (e.g.,
+                    no privileges, admission test failed, or a restricted
+                    CPU affinity), the task keeps running under the fallback
+                    policy: task_get_policy tells which one is in use.
+                    With an admission test (attr->admission), the task is
+                    only created if the live tasks, including it, pass the
+                    test (see task_check_schedulability), using the declared
+                    WCET attr->wcet_ns; otherwise, EAGAIN is returned.
+                    In the simulation mode, attr->wcet_ns is required, as
+                    the execution time of each job (see sim_job_end).
+                    Return EINVAL if the attributes are not valid, or the
+                    errno of mlockall if the memory cannot be locked
+_____________________________________________________________________________*/
+
+int task_create_ns(void *(*task)(void *), int j, int64_t per, int64_t dl_r,
+                   int pri, const struct task_attr *attr)
+{
+    return task_create_common(task, j, per, dl_r, pri, attr, 1);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_CREATE_JOB:    Same as task_create_ns, but no thread is created: the
+                        activations of the j-th task ("job") are run by
+                        someone else (e.g., the dispatcher worker threads),
+                        which records their statistics through
+                        task_update_stats. The policy, placement and stack
+                        attributes are ignored. The job must be destroyed by
+                        task_destroy_job
+_____________________________________________________________________________*/
+
+int task_create_job(int j, int64_t per, int64_t dl_r, int pri,
+                    const struct task_attr *attr)
+{
+    return task_create_common(NULL, j, per, dl_r, pri, attr, 0);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_INDEX: Retrieve task index (stored in tp->ind)
+_____________________________________________________________________________*/
+
+int task_get_index(void *ind)
+{
+    struct task_par *tpar; /* Since the thread argument is passed as a pointer
+                              to void, such a pointer must first be converted
+                              to a pointer to task_par */
+
+    tpar = (struct task_par *)ind;
+
+    return tpar->ind;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_PERIOD:    Get j-th task period
+_____________________________________________________________________________*/
+
+int task_get_period(int j) { return TP(j)->per; }
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_PERIOD_NS: Get j-th task period, expressed in [ns]
+_____________________________________________________________________________*/
+
+int64_t task_get_period_ns(int j) { return TP(j)->per_ns; }
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_DEADLINE_NS:   Get j-th task relative deadline, expressed in [ns]
+_____________________________________________________________________________*/
+
+int64_t task_get_deadline_ns(int j) { return TP(j)->dl_r_ns; }
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_MAX_PRIORITY:  Return the priority of the task(s) with the highest
+                            one, among the live tasks (0 if there is none)
+_____________________________________________________________________________*/
+
+int task_get_max_priority()
+{
+    int l;             // for-loop index
+    int max_priority;  // maximum task priority
+
+    max_priority = 0;
+
+    pthread_mutex_lock(&reg_lock);
+    for (l = 0; l < reg_n_live; l++)
+        max_priority = fmax(TP(reg_live[l])->pri, max_priority);
+    pthread_mutex_unlock(&reg_lock);
+
+    return max_priority;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_POLICY:    Get the scheduling policy the j-th task is running
+                        under (SCHED_RR, SCHED_FIFO or SCHED_DEADLINE). If
+                        SCHED_DEADLINE was requested, it is only valid once
+                        the task has started
+_____________________________________________________________________________*/
+
+int task_get_policy(int j) { return TP(j)->policy; }
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_MAX_PERIOD:    Return the period of the task(s) with the highest
+                            one, among the live tasks (0 if there is none)
+_____________________________________________________________________________*/
+
+int task_get_max_period()
+{
+    int l;           // for-loop index
+    int max_period;  // maximum task period
+
+    max_period = 0;
+
+    pthread_mutex_lock(&reg_lock);
+    for (l = 0; l < reg_n_live; l++)
+        max_period = fmax(TP(reg_live[l])->per, max_period);
+    pthread_mutex_unlock(&reg_lock);
+
+    return max_period;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_MAX_PRERIOD:   Deprecated (misspelled) name of
+                            task_get_max_period, kept for compatibility
+_____________________________________________________________________________*/
+
+int task_get_max_preriod() { return task_get_max_period(); }
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_SET_ACTIVATION:    Read the current time, then compute the next
+                            activation time and the absolute deadline of the
+                            j-th task.
+                            It must be called by the task itself: page faults
+                            are counted from here on (see
+                            task_get_page_faults). In the simulation mode,
+                            it waits for the first job to be scheduled
+_____________________________________________________________________________*/
+
+void task_set_activation(int j)
+{
+    struct timespec t;
+
+    TP(j)->pf_base = get_thread_page_faults();  // warm-up is over
+
+    time_now(&t);
+    time_copy(&(TP(j)->at), t);
+    time_copy(&(TP(j)->dl_a), t);
+    time_add_ns(&(TP(j)->at), TP(j)->per_ns);
+    time_add_ns(&(TP(j)->dl_a), TP(j)->dl_r_ns);
+
+    if (sim_is_active() &&
+        sim_wait(j, timespec2ns(t), timespec2ns(TP(j)->dl_a)) < 0)
+        TP(j)->stop = 1;  // past the simulation horizon
+
+    wd_arm(TP(j));
+    perf_begin(TP(j));
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_CHECK_DEADLINE_MISS:   Check whether a deadline miss occured.
+                                If yes, increment the amount of deadline misses
+                                for the j-th thread and return 1
+                                If not, return 0
+_____________________________________________________________________________*/
+
+int task_check_deadline_miss(int j)
+{
+    struct timespec now;
+
+    sim_job_end(j);
+    time_now(&now);
+
+    if (wd_end(TP(j), &now))  // already counted by the watchdog
+        return 1;
+
+    if (time_cmp(now, TP(j)->dl_a) > 0) {
+        task_stats_write_begin(j);
+        __atomic_fetch_add(&(TP(j)->dm), 1, __ATOMIC_RELAXED);
+        task_stats_write_end(j);
+        return 1;
+    }
+
+    return 0;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_DEADLINE_MISS: Retrieve the current amount of deadline misses for
+                            the j-th task
+_____________________________________________________________________________*/
+
+int task_get_deadline_miss(int j) { return TP(j)->dm; }
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_SET_DEADLINE_MISS: Set the current amount of deadline misses for the
+                            j-th task to dm
+_____________________________________________________________________________*/
+
+int task_set_deadline_miss(int j, int dm)
+{
+    assert(dm >= 0);
+    TP(j)->dm = dm;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_ADD_DEADLINE_MISS: Atomically add n to the amount of deadline misses
+                            of the j-th task. Unlike task_set_deadline_miss,
+                            it can be called by any thread, concurrently
+                            with the task (e.g., by the dispatcher, for a
+                            skipped release)
+_____________________________________________________________________________*/
+
+void task_add_deadline_miss(int j, int n)
+{
+    assert(n >= 0);
+    __atomic_fetch_add(&(TP(j)->dm), n, __ATOMIC_RELAXED);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    APPLY_OVERRUN:  If the next activation of the task pointed by tpar is
+                    already past at time now (i.e., the last job overran its
+                    period), move it according to the overrun policy of the
+                    task, and count the skipped activations
+_____________________________________________________________________________*/
+
+static void apply_overrun(struct task_par *tpar, struct timespec *now)
+{
+    int64_t late;  // time elapsed since the next activation            [ns]
+    int64_t k;     // number of skipped activations
+    int64_t shift; // shift of activation time and absolute deadline   [ns]
+
+    late = get_time_diff_in_ns(now, &(tpar->at));
+    if (late <= 0)
+        return;
+
+    k = late / tpar->per_ns;  // activations released in (at, now]
+    switch (tpar->overrun) {
+    case TASK_OVERRUN_SKIP:  // to the first activation after now
+        k++;
+        shift = k * tpar->per_ns;
+        break;
+    case TASK_OVERRUN_REPHASE:  // activated now, with a new phase
+        shift = late;
+        break;
+    default:  // TASK_OVERRUN_CATCHUP
+        return;
+    }
+
+    time_add_ns(&(tpar->at), shift);
+    time_add_ns(&(tpar->dl_a), shift);
+
+    if (k > 0) {
+        task_stats_write_begin(tpar->ind);
+        tpar->skip += k;
+        task_stats_write_end(tpar->ind);
+    }
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    WAIT_NEXT_PERIOD:   Body of task_wait_for_period, for the task pointed by
+                        tpar; now is the current time, if already known (NULL
+                        otherwise), and the wake-up time is stored in wake
+_____________________________________________________________________________*/
+
+static void wait_next_period(struct task_par *tpar, struct timespec *now,
+                             struct timespec *wake)
+{
+    struct timespec t;      // current time, if not given
+    int             cpu;    // CPU of the new activation
+    int64_t         lat;    // wake-up latency                           [ns]
+    double          delta;  // distance of the new sample from the mean  [ns]
+    int64_t        *value;  // slot of the latency sample
+
+    if (sim_job_end(tpar->ind) < 0) {  // past the simulation horizon
+        tpar->stop = 1;
+        return;
+    }
+    perf_end(tpar);
+    wd_end(tpar, now);
+
+    if (tpar->overrun != TASK_OVERRUN_CATCHUP) {
+        if (!now) {
+            time_now(&t);
+            now = &t;
+        }
+        apply_overrun(tpar, now);
+    }
+
+    if (!sim_is_active())
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &(tpar->at), NULL);
+    else if (sim_wait(tpar->ind, timespec2ns(tpar->at),
+                      timespec2ns(tpar->at) + tpar->dl_r_ns) < 0) {
+        tpar->stop = 1;
+        return;
+    }
+    time_now(wake);
+
+    cpu = sched_getcpu();
+    lat = get_time_diff_in_ns(wake, &(tpar->at));
+
+    task_stats_write_begin(tpar->ind);
+
+    if (cpu != tpar->cpu) {
+        if (tpar->cpu >= 0)
+            tpar->migr++;
+        tpar->cpu = cpu;
+    }
+
+    value = (int64_t *)rt_store_slot(&(tpar->lat_values), tpar->lat_n);
+    if (value)
+        *value = lat;
+    tpar->lat_n++;
+    tpar->lat_last = lat;
+    if (lat < tpar->lat_min)
+        tpar->lat_min = lat;
+    if (lat > tpar->lat_max)
+        tpar->lat_max = lat;
+    delta = lat - tpar->lat_mean;
+    tpar->lat_mean += delta / tpar->lat_n;
+    tpar->lat_m2 += delta * (lat - tpar->lat_mean);
+
+    task_stats_write_end(tpar->ind);
+
+    time_add_ns(&(tpar->at), tpar->per_ns);
+    time_add_ns(&(tpar->dl_a), tpar->per_ns);
+
+    wd_arm(tpar);
+    perf_begin(tpar);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_WAIT_FOR_PERIOD:   Suspend the calling thread until the next
+                            activation and, when awaken, record the wake-up
+                            latency (actual wake-up time minus activation
+                            time), check whether the task has been migrated
+                            to another CPU, and update activation time and
+                            absolute deadline. If the next activation is
+                            already past, it is first moved according to the
+                            overrun policy of the task (see task_attr_init)
+_____________________________________________________________________________*/
+
+void task_wait_for_period(int j)
+{
+    struct timespec wake;  // wake-up time
+
+    wait_next_period(TP(j), NULL, &wake);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_RUN_PERIODIC:  Run the periodic loop of the j-th task: it must be
+                        called by the task itself, and it replaces
+                        task_set_activation, the manual response time
+                        measurement and statistics update, the deadline
+                        check and task_wait_for_period. At each activation,
+                        body(j, ctx) is run, and its response time is
+                        measured with two clock reads (the wake-up one, also
+                        used for the wake-up latency, and the end one, also
+                        used for the deadline check), then all the statistics
+                        are updated at once (see task_update_stats).
+                        The loop ends when body returns a non-zero value, or
+                        after task_stop is called (at the end of the current
+                        activation, or of the current period if waiting).
+                        Return the value returned by body (0 if stopped)
+_____________________________________________________________________________*/
+
+int task_run_periodic(int j, int (*body)(int j, void *ctx), void *ctx)
+{
+    struct task_par *tpar;
+    struct timespec  start;  // start time of the current activation
+    struct timespec  end;    // end time of the current activation
+    int64_t          cpu;    // thread CPU time at the start           [ns]
+    int64_t          exec;   // execution time of the activation       [ns]
+    int              miss;   // 1 if the deadline was missed
+    int              caught; // 1 if the watchdog counted the miss
+    int              ret;    // return value of body
+
+    tpar = TP(j);
+    ret  = 0;
+
+    task_set_activation(j);
+
+    time_now(&start);
+
+    while (!__atomic_load_n(&(tpar->stop), __ATOMIC_RELAXED)) {
+        cpu  = tpar->exec_time ? time_thread_cpu_ns() : 0;
+        ret  = body(j, ctx);
+        exec = tpar->exec_time ? time_thread_cpu_ns() - cpu : 0;
+        if (sim_job_end(j) < 0)  // past the simulation horizon
+            break;
+        time_now(&end);
+        perf_end(tpar);
+
+        caught = wd_end(tpar, &end);
+        miss   = caught || time_cmp(end, tpar->dl_a) > 0;
+        task_stats_write_begin(j);
+        if (miss && !caught)
+            __atomic_fetch_add(&(tpar->dm), 1, __ATOMIC_RELAXED);
+        task_update_stats_at(j, get_time_diff_in_ms(&end, &start),
+                             timespec2ns(end));
+        if (tpar->exec_time)
+            task_update_exec(j, exec);
+        task_stats_write_end(j);
+        trace_record(j, tpar->ex_tot, timespec2ns(tpar->at) - tpar->per_ns,
+                     timespec2ns(start), timespec2ns(end), miss);
+
+        if (ret != 0 || __atomic_load_n(&(tpar->stop), __ATOMIC_RELAXED))
+            break;
+        wait_next_period(tpar, &end, &start);  // wake-up time is the start
+    }
+
+    return ret;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_STOP:  Ask the periodic loop of the j-th task (see task_run_periodic)
+                to end. It can be called from any thread; task_wait_for_end
+                can then be used to join the task
+_____________________________________________________________________________*/
+
+void task_stop(int j) { __atomic_store_n(&(TP(j)->stop), 1, __ATOMIC_RELAXED); }
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_WAIT_FOR_END:  Join the j-th task, free the response time arrays and
+                        release its index (it may then be reused by
+                        task_alloc). Its statistics can still be read until
+                        the index is reused
+_____________________________________________________________________________*/
+
+int task_wait_for_end(int j)
+{
+    int rc;  // pthread_join return code (0 in case of success)
+
+    assert(j < TASK_MAX);
+    assert(j >= 0);
+
+    sim_start();  // no effect out of the simulation mode
+    rc = pthread_join(TP(j)->tid, NULL);
+
+    rt_store_free(&(TP(j)->rt_values));
+    rt_store_free(&(TP(j)->rt_indexes));
+    rt_store_free(&(TP(j)->lat_values));
+    shm_unpublish(TP(j));
+    reg_release(j);
+
+    return rc;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_DESTROY_JOB:   Free the response time arrays of the j-th job (see
+                        task_create_job) and release its index, as
+                        task_wait_for_end does for a task. No activation of
+                        the job must be running
+_____________________________________________________________________________*/
+
+void task_destroy_job(int j)
+{
+    assert(j < TASK_MAX);
+    assert(j >= 0);
+
+    rt_store_free(&(TP(j)->rt_values));
+    rt_store_free(&(TP(j)->rt_indexes));
+    rt_store_free(&(TP(j)->lat_values));
+    shm_unpublish(TP(j));
+    reg_release(j);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_RT_AVG:    Get j-th task average response time
+_____________________________________________________________________________*/
+
+double task_get_rt_avg(int j) { return TP(j)->rt_avg; };
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_RT_MAX:    Get j-th task maximum response time
+_____________________________________________________________________________*/
+
+double task_get_rt_max(int j) { return TP(j)->rt_max; };
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_RT_MIN:    Get j-th task minimum response time
+_____________________________________________________________________________*/
+
+double task_get_rt_min(int j) { return TP(j)->rt_min; };
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_RT_TOT:    Get j-th task summation of response times
+_____________________________________________________________________________*/
+
+double task_get_rt_tot(int j) { return TP(j)->rt_tot; };
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_RT_STD:    Get j-th task standard deviation of response times
+_____________________________________________________________________________*/
+
+double task_get_rt_std(int j) { return TP(j)->rt_std; };
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_UTIL_INST: Get j-th task instantaneous utilization factor
+_____________________________________________________________________________*/
+
+double task_get_util_inst(int j) { return TP(j)->util_inst; };
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_UTIL_INST_MAX: Get j-th task maximum instantaneous utilization
+                            factor
+_____________________________________________________________________________*/
+
+double task_get_util_inst_max(int j) { return TP(j)->util_inst_max; };
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_UTIL_AVG:  Get j-th task average utilization factor
+_____________________________________________________________________________*/
+
+double task_get_util_avg(int j) { return TP(j)->util_avg; };
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_RT_VALUES: Get the response time values array of the j-th task
+                        (see rt_store_flat for its layout in each storage mode;
+                        NULL in chunked mode, unless in RT memory mode)
+_____________________________________________________________________________*/
+
+double *task_get_rt_values(int j)
+{
+    return (double *)rt_store_flat(&(TP(j)->rt_values));
+};
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_RT_INDEXES:    Get the response time indexes array of the j-th task
+                            (see rt_store_flat for its layout in each storage
+                            mode; NULL in chunked mode, unless in RT memory
+                            mode)
+_____________________________________________________________________________*/
+
+unsigned long *task_get_rt_indexes(int j)
+{
+    return (unsigned long *)rt_store_flat(&(TP(j)->rt_indexes));
+};
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_RT_VALUE:  Get the m-th response time value of the j-th task
+                        Return NAN if such a value is not stored (anymore)
+_____________________________________________________________________________*/
+
+double task_get_rt_value(int j, unsigned long m)
+{
+    const double *rt_value;
+
+    if (m < rt_store_first(&(TP(j)->rt_values), TP(j)->ex_tot + 1))
+        return NAN;
+
+    rt_value = (const double *)rt_store_peek(&(TP(j)->rt_values), m);
+
+    return rt_value ? *rt_value : NAN;
+};
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_RT_INDEX:  Get the m-th response time index of the j-th task
+                        Return 0 if such an index is not stored (anymore)
+_____________________________________________________________________________*/
+
+unsigned long task_get_rt_index(int j, unsigned long m)
+{
+    const unsigned long *rt_index;
+
+    if (m < rt_store_first(&(TP(j)->rt_indexes), TP(j)->ex_tot + 1))
+        return 0;
+
+    rt_index = (const unsigned long *)rt_store_peek(&(TP(j)->rt_indexes), m);
+
+    return rt_index ? *rt_index : 0;
+};
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_EX_TOT:    Get the (total) number of executions for the j-th task
+_____________________________________________________________________________*/
+
+unsigned long task_get_ex_tot(int j) { return TP(j)->ex_tot; };
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_STATS: Copy a consistent snapshot of the statistics of the j-th
+                    task into the structure pointed by st. It can be called by
+                    any thread (e.g., a monitor) while the task is running:
+                    the statistics are protected by a sequence lock, so the
+                    task never blocks, while the reader retries whenever the
+                    task updated them during the copy
+_____________________________________________________________________________*/
+
+void task_get_stats(int j, struct task_stats *st)
+{
+    struct task_par      *tpar;
+    unsigned              seq_start;  // sequence counter before the copy
+    unsigned              seq_end;    // sequence counter after the copy
+    int                   tries;      // number of attempts
+    const struct timespec pause = {0, 10000};  // sleep between attempts
+
+    tpar  = TP(j);
+    tries = 0;
+
+    do {
+        if (++tries > STATS_SPIN)
+            nanosleep(&pause, NULL);
+
+        seq_start = __atomic_load_n(&(tpar->seq), __ATOMIC_ACQUIRE);
+        if (seq_start & 1) {  // update in progress
+            seq_end = seq_start + 1;
+            continue;
+        }
+
+        st->ex_tot        = tpar->ex_tot;
+        st->dm            = tpar->dm;
+        st->cpu           = tpar->cpu;
+        st->migr          = tpar->migr;
+        st->skip          = tpar->skip;
+        st->lat_n         = tpar->lat_n;
+        st->lat_last      = tpar->lat_last;
+        st->lat_min       = tpar->lat_min;
+        st->lat_max       = tpar->lat_max;
+        st->lat_avg       = tpar->lat_mean;
+        st->lat_std       = tpar->lat_m2;  // turned into a std. dev. below
+        st->rt_last       = tpar->rt_last;
+        st->rt_avg        = tpar->rt_avg;
+        st->rt_max        = tpar->rt_max;
+        st->rt_min        = tpar->rt_min;
+        st->rt_tot        = tpar->rt_tot;
+        st->rt_std        = tpar->rt_std;
+        st->util_inst     = tpar->util_inst;
+        st->util_inst_max = tpar->util_inst_max;
+        st->util_avg      = tpar->util_avg;
+        st->win_n         = rt_window_count(&(tpar->win));
+        st->win_dm        = rt_window_dm(&(tpar->win));
+        st->win_rt_avg    = rt_window_avg(&(tpar->win));
+        st->win_rt_max    = rt_window_max(&(tpar->win));
+        st->win_rt_min    = rt_window_min(&(tpar->win));
+        st->win_rt_std    = rt_window_std(&(tpar->win));
+        st->exec_n        = tpar->exec_n;
+        st->exec_last     = tpar->exec_last;
+        st->exec_min      = tpar->exec_min;
+        st->exec_max      = tpar->exec_max;
+        st->exec_avg      = tpar->exec_mean;
+        st->perf_n        = tpar->perf_n;
+        memcpy(st->perf_max, tpar->perf_max, sizeof(st->perf_max));
+        memcpy(st->perf_avg, tpar->perf_mean, sizeof(st->perf_avg));
+        st->wd_n          = tpar->wd_n;
+        st->wd_ovr_last   = tpar->wd_ovr_last;
+        st->wd_ovr_max    = tpar->wd_ovr_max;
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        seq_end = __atomic_load_n(&(tpar->seq), __ATOMIC_RELAXED);
+    } while (seq_start != seq_end);
+
+    st->lat_std  = st->lat_n > 1 ? sqrt(st->lat_std / (st->lat_n - 1)) : 0;
+    st->cpu_util = st->exec_avg / tpar->per_ns;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_STATS_WRITE_BEGIN: Mark the beginning of an update of the statistics
+                            of the j-th task, so that task_get_stats does not
+                            return a partially updated snapshot. It must be
+                            called by the task itself (the only writer) and
+                            matched by task_stats_write_end; nesting is
+                            allowed. It never blocks, and costs two plain
+                            stores (on x86)
+_____________________________________________________________________________*/
+
+void task_stats_write_begin(int j)
+{
+    struct task_par *tpar;
+
+    tpar = TP(j);
+
+    if (tpar->seq_depth++ > 0)
+        return;
+
+    __atomic_store_n(&(tpar->seq), tpar->seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_STATS_WRITE_END:   Mark the end of an update of the statistics of the
+                            j-th task (see task_stats_write_begin)
+_____________________________________________________________________________*/
+
+void task_stats_write_end(int j)
+{
+    struct task_par *tpar;
+
+    tpar = TP(j);
+
+    if (--tpar->seq_depth > 0)
+        return;
+
+    __atomic_store_n(&(tpar->seq), tpar->seq + 1, __ATOMIC_RELEASE);
+
+    if (tpar->shm)
+        shm_publish(tpar);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_UPDATE_STATS:  Record rt_value as the response time of a new
+                        activation of the j-th task, and update all of its
+                        statistics (ex_tot, rt_*, util_*) accordingly, as a
+                        single update for task_get_stats.
+                        It replaces the sequence task_set_rt_value,
+                        task_increment_rt_tot, task_compute_* and task_set_*
+                        of each activation. The first call records the sample
+                        0, the next ones increment ex_tot. The deadline misses
+                        counted since the previous call are charged to this
+                        activation in the sliding window (see win_len), which
+                        records it at end_ns [ns], its completion time (only
+                        used by a time window, see win_ns)
+_____________________________________________________________________________*/
+
+void task_update_stats_at(int j, double rt_value, int64_t end_ns)
+{
+    struct task_par *tpar;
+    unsigned long    m;      // index of the new activation
+    double          *value;  // slot of the response time
+    unsigned long   *index;  // slot of its index
+
+    assert(rt_value >= 0);
+
+    tpar = TP(j);
+    m    = tpar->rt_n;
+
+    task_stats_write_begin(j);
+
+    value = (double *)rt_store_slot(&(tpar->rt_values), m);
+    if (value)
+        *value = rt_value;
+    index = (unsigned long *)rt_store_slot(&(tpar->rt_indexes), m);
+    if (index)
+        *index = m;
+
+    if (tpar->rt_hist.count)
+        pct_hist_add(&(tpar->rt_hist), llround(rt_value * NSEC_PER_MSEC));
+
+    /* The deadline misses since the last update belong to this activation */
+    if (tpar->win.cap)
+        rt_window_add(&(tpar->win), rt_value,
+                      tpar->win.span_ns ? end_ns : 0,
+                      tpar->dm > tpar->win_dm ? tpar->dm - tpar->win_dm : 0);
+    tpar->win_dm = tpar->dm;
+
+    tpar->rt_last = rt_value;
+    tpar->ex_tot  = m;
+    task_increment_rt_tot(j, rt_value);
+
+    tpar->rt_max        = task_compute_rt_max(j);
+    tpar->rt_min        = task_compute_rt_min(j);
+    tpar->rt_avg        = task_compute_rt_avg(j);
+    tpar->rt_std        = task_compute_std_dev(j);
+    tpar->util_inst     = task_compute_util_inst(j);
+    tpar->util_inst_max = task_compute_util_inst_max(j);
+    tpar->util_avg      = task_compute_util_avg(j);
+
+    task_stats_write_end(j);
+}
 //-----------------------------------------------------------------------------
 
 
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
-    TASK_CREATE:    Create a task with a given period (per, expressed in [ms]),
-                    relative deadline (dl_r; expressed in [ms]) and priority
-                    (pri; value in {1, ..., LINUX_MAX_PRIO}).
-                    The task index (j) is decided by the user.
-                    The user must guarantee that:
-                        * each task is assigned a different index
-                        * the index does not exceed the size of the tp array
-                          (i.e., in {0, ..., NT - 1})
+    TASK_UPDATE_STATS:  Same as task_update_stats_at, the activation being
+                        completed now (the time is only read if the j-th
+                        task has a time window)
 _____________________________________________________________________________*/
 
-int task_create(void *(*task)(void *), int j, int per, int dl_r, int pri)
+void task_update_stats(int j, double rt_value)
 {
-    pthread_attr_t     myatt;
-    struct sched_param mypar;
-    int                tret;
+    task_update_stats_at(j, rt_value,
+                         TP(j)->win.span_ns ? time_now_ns() : 0);
+}
+//-----------------------------------------------------------------------------
 
-    assert(j < NT);
-    assert(j >= 0);
-    assert(per >= 0);
-    assert(dl_r >= 0);
-    assert(pri >= 0);
-    assert(pri <= LINUX_MAX_PRIO);
 
-    tp[j].ind    = j;
-    tp[j].per    = per;
-    tp[j].dl_r   = dl_r;
-    tp[j].pri    = pri;
-    tp[j].dm     = 0;
-    tp[j].rt_avg = 0;
-    tp[j].rt_max = 0;
-    tp[j].rt_min = DBL_MAX;  // max. finite representable floating-point number
-    tp[j].rt_tot = 0;
-    tp[j].rt_std = 0;
-    tp[j].util_inst = 0;
-    tp[j].util_avg  = 0;
-    tp[j].ex_tot    = 0;
-
-    tp[j].rt_values = (double *)malloc(GOOGOL * sizeof(double));
-    if (!tp[j].rt_values && (GOOGOL * sizeof(double) > 0)) {
-        perror("malloc failed!");
-        exit(EXIT_FAILURE);
-    }
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_UPDATE_EXEC:   Record exec_ns as the execution time (i.e., the CPU
+                        time, see time_thread_cpu_ns) of the last activation
+                        of the j-th task, and update the execution time
+                        statistics. Unlike the response time, it does not
+                        count the time the task is preempted, so its maximum
+                        is an estimate of the WCET. It is called by
+                        task_run_periodic and by the dispatcher; it must be
+                        called by the task itself
+_____________________________________________________________________________*/
 
-    tp[j].rt_indexes = (unsigned long *)malloc(GOOGOL * sizeof(unsigned long));
-    if (!tp[j].rt_indexes && (GOOGOL * sizeof(unsigned long) > 0)) {
-        perror("malloc failed!");
-        exit(EXIT_FAILURE);
-    }
+void task_update_exec(int j, int64_t exec_ns)
+{
+    struct task_par *tpar;
 
-    pthread_attr_init(&myatt);
-    pthread_attr_setinheritsched(&myatt, PTHREAD_EXPLICIT_SCHED);
-    pthread_attr_setschedpolicy(&myatt, SCHED_RR);
-    mypar.sched_priority = tp[j].pri;
-    pthread_attr_setschedparam(&myatt, &mypar);
+    assert(exec_ns >= 0);
 
-    tret = pthread_create(&tid[j], &myatt, task, (void *)(&tp[j]));
+    tpar = TP(j);
 
-    return tret;
+    task_stats_write_begin(j);
+
+    tpar->exec_n++;
+    tpar->exec_last = exec_ns;
+    if (exec_ns < tpar->exec_min)
+        tpar->exec_min = exec_ns;
+    if (exec_ns > tpar->exec_max)
+        tpar->exec_max = exec_ns;
+    tpar->exec_mean += (exec_ns - tpar->exec_mean) / tpar->exec_n;
+
+    task_stats_write_end(j);
 }
 //-----------------------------------------------------------------------------
 
 
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
-    TASK_GET_INDEX: Retrieve task index (stored in tp->ind)
+    TASK_GET_PAGE_FAULTS:   Get the number of page faults taken by the j-th
+                            task after its warm-up (i.e., since it called
+                            task_set_activation), or -1 if it cannot be read.
+                            While the task is running, it is read from /proc,
+                            so it can be called from any thread
 _____________________________________________________________________________*/
 
-int task_get_index(void *ind)
+long task_get_page_faults(int j)
 {
-    struct task_par *tpar; /* Since the thread argument is passed as a pointer
-                              to void, such a pointer must first be converted
-                              to a pointer to task_par */
+    char  path[64];
+    char  line[1024];
+    char *p;
+    long  minflt;  // minor page faults
+    long  majflt;  // major page faults
+    FILE *f;
+
+    if (TP(j)->pf_done)
+        return TP(j)->pf_end - TP(j)->pf_base;
+    if (TP(j)->tid_os == 0)
+        return -1;
+
+    snprintf(path, sizeof(path), "/proc/self/task/%d/stat", (int)TP(j)->tid_os);
+    f = fopen(path, "r");
+    if (!f)
+        return -1;
+    p = fgets(line, sizeof(line), f);
+    fclose(f);
+    if (!p)
+        return -1;
+
+    /* Skip "pid (comm)", as comm may contain spaces, then: state, ppid, pgrp,
+       session, tty_nr, tpgid, flags, minflt, cminflt, majflt */
+    p = strrchr(line, ')');
+    if (!p || sscanf(p + 2, "%*c %*d %*d %*d %*d %*d %*u %ld %*u %ld", &minflt,
+                     &majflt) != 2)
+        return -1;
+
+    return minflt + majflt - TP(j)->pf_base;
+}
+//-----------------------------------------------------------------------------
 
-    tpar = (struct task_par *)ind;
 
-    return tpar->ind;
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_CHECK_SCHEDULABILITY:  Run the given schedulability test on the live
+                                tasks (fixed priorities; see analyze_live):
+                                    * ANALYSIS_LL: Liu & Layland bound
+                                    * ANALYSIS_HYPERBOLIC: hyperbolic bound
+                                    * ANALYSIS_RTA: response time analysis
+                                The worst-case response time of each task is
+                                computed in any case (see task_get_wcrt_ns).
+                                Return 1 if the tasks are schedulable, 0
+                                otherwise
+_____________________________________________________________________________*/
+
+int task_check_schedulability(int test)
+{
+    int ok;
+
+    assert(test >= ANALYSIS_NONE && test <= ANALYSIS_RTA);
+
+    pthread_mutex_lock(&reg_lock);
+    ok = analyze_live(test, 0);
+    pthread_mutex_unlock(&reg_lock);
+
+    return ok;
 }
 //-----------------------------------------------------------------------------
 
 
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
-    TASK_GET_PERIOD:    Get j-th task period
+    TASK_GET_WCRT_NS:   Get the worst-case response time of the j-th task, as
+                        computed by the last schedulability analysis, in [ns]
+                        (-1 if it has not been analyzed; a value greater than
+                        its deadline if it may miss it)
 _____________________________________________________________________________*/
 
-int task_get_period(int j) { return tp[j].per; }
+int64_t task_get_wcrt_ns(int j) { return TP(j)->wcrt_ns; }
 //-----------------------------------------------------------------------------
 
 
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
-    TASK_GET_MAX_PRIORITY:  Return the priority of the task(s) with the highest
-                            one, among the entire task set
+    TASK_GET_SKIPPED:   Get the number of activations of the j-th task that
+                        were skipped because of overruns (see the overrun
+                        policy in task_attr_init). They are not counted as
+                        deadline misses
 _____________________________________________________________________________*/
 
-int task_get_max_priority()
-{
-    int j;             // task index
-    int max_priority;  // maximum task priority
+unsigned long task_get_skipped(int j) { return TP(j)->skip; }
+//-----------------------------------------------------------------------------
 
-    max_priority = tp[0].pri;
 
-    for (j = 1; j < NT; j++)
-        max_priority = fmax(tp[j].pri, max_priority);
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_LAT_COUNT: Get the number of wake-up latencies recorded for the
+                        j-th task (one per task_wait_for_period)
+_____________________________________________________________________________*/
 
-    return max_priority;
+unsigned long task_get_lat_count(int j) { return TP(j)->lat_n; }
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_LAT_LAST:  Get the last wake-up latency of the j-th task, in [ns]
+_____________________________________________________________________________*/
+
+int64_t task_get_lat_last(int j) { return TP(j)->lat_last; }
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_LAT_MIN:   Get the minimum wake-up latency of the j-th task, in
+                        [ns] (INT64_MAX if none has been recorded yet)
+_____________________________________________________________________________*/
+
+int64_t task_get_lat_min(int j) { return TP(j)->lat_min; }
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_LAT_MAX:   Get the maximum wake-up latency of the j-th task, in
+                        [ns]
+_____________________________________________________________________________*/
+
+int64_t task_get_lat_max(int j) { return TP(j)->lat_max; }
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_LAT_AVG:   Get the average wake-up latency of the j-th task, in
+                        [ns]
+_____________________________________________________________________________*/
+
+double task_get_lat_avg(int j) { return TP(j)->lat_mean; }
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_LAT_STD:   Get the standard deviation of the wake-up latency of
+                        the j-th task, in [ns] (0 if less than two have been
+                        recorded)
+_____________________________________________________________________________*/
+
+double task_get_lat_std(int j)
+{
+    unsigned long n;  // number of samples
+
+    n = TP(j)->lat_n;
+    if (n < 2)
+        return 0;
+
+    return sqrt(TP(j)->lat_m2 / (n - 1));
 }
 //-----------------------------------------------------------------------------
 
 
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
-    TASK_GET_MAX_PERIOD:    Return the period of the task(s) with the highest
-                            one, among the entire task set
+    TASK_GET_JITTER:    Get the release jitter of the j-th task, i.e., the
+                        difference between the maximum and the minimum
+                        wake-up latency, in [ns] (0 if none is recorded)
 _____________________________________________________________________________*/
 
-int task_get_max_period()
+int64_t task_get_jitter(int j)
 {
-    int j;           // task index
-    int max_period;  // maximum task period
+    if (TP(j)->lat_n == 0)
+        return 0;
+
+    return TP(j)->lat_max - TP(j)->lat_min;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_LAT_VALUE: Get the k-th wake-up latency of the j-th task (i.e.,
+                        the one of the activation k + 1), in [ns], if stored
+                        (see attr->lat_store); -1 otherwise
+_____________________________________________________________________________*/
 
-    max_period = tp[0].per;
+int64_t task_get_lat_value(int j, unsigned long k)
+{
+    const int64_t *value;
 
-    for (j = 1; j < NT; j++)
-        max_period = fmax(tp[j].per, max_period);
+    value = (const int64_t *)rt_store_peek(&(TP(j)->lat_values), k);
 
-    return max_period;
+    return value ? *value : -1;
 }
 //-----------------------------------------------------------------------------
 
 
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
-    TASK_SET_ACTIVATION:    Read the current time, then compute the next
-                            activation time and the absolute deadline of the
-                            j-th task
+    TASK_GET_RT_PERCENTILE: Get the q-th percentile (q in [0, 100]) of the
+                            response time of the j-th task [ms] (see
+                            task_get_rt_percentiles, with TASK_PCT_AUTO), or
+                            NAN if it cannot be computed
 _____________________________________________________________________________*/
 
-void task_set_activation(int j)
+double task_get_rt_percentile(int j, double q)
 {
-    struct timespec t;
+    double rt;
+
+    if (task_get_rt_percentiles(j, &q, &rt, 1, TASK_PCT_AUTO) != 0)
+        return NAN;
 
-    clock_gettime(CLOCK_MONOTONIC, &t);
-    time_copy(&(tp[j].at), t);
-    time_copy(&(tp[j].dl_a), t);
-    time_add_ms(&(tp[j].at), tp[j].per);
-    time_add_ms(&(tp[j].dl_a), tp[j].dl_r);
+    return rt;
 }
 //-----------------------------------------------------------------------------
 
 
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
-    TASK_CHECK_DEADLINE_MISS:   Check whether a deadline miss occured.
-                                If yes, increment the amount of deadline misses
-                                for the j-th thread and return 1
-                                If not, return 0
+    TASK_GET_RT_PERCENTILES:    Get the q[i]-th percentiles (q[i] in [0,
+                                100]; nearest rank) of the response time of
+                                the j-th task into rt[i] [ms], for i in {0,
+                                ..., n - 1}, according to mode:
+                                    * TASK_PCT_EXACT: over the stored
+                                      response times (see attr->rt_store),
+                                      copied and partially reordered by
+                                      selection, in O(samples) on average
+                                    * TASK_PCT_STREAM: from the histogram of
+                                      all the response times (see
+                                      attr->rt_hist), within 0.4%
+                                      (1 / 2^(PCT_SUB_BITS + 1)), in O(1)
+                                    * TASK_PCT_AUTO: exact if any response
+                                      time is stored, streaming otherwise.
+                                The histogram is kept after the task ends,
+                                until the index is reused.
+                                Return 0 in case of success, EINVAL for an
+                                invalid q or mode, ENODATA if no response
+                                time is available in that mode, ENOMEM if
+                                the samples cannot be copied
 _____________________________________________________________________________*/
 
-int task_check_deadline_miss(int j)
+int task_get_rt_percentiles(int j, const double *q, double *rt, int n,
+                            int mode)
 {
-    struct timespec now;
+    struct task_par *tpar;
+    const double    *span;   // current run of samples
+    double          *v;      // copy of the stored response times
+    unsigned long    first;  // index of the oldest stored sample
+    unsigned long    last;   // index of the newest stored sample (excluded)
+    unsigned long    m;      // sample index
+    unsigned long    len;    // length of the current run of samples
+    unsigned long    n_v;    // number of samples in v
+    unsigned long    k;      // rank of a percentile
+    int              i;      // for-loop index
+    int              ret;
+
+    tpar = TP(j);
+
+    for (i = 0; i < n; i++)
+        if (!(q[i] >= 0 && q[i] <= 100))
+            return EINVAL;
+    if (mode < TASK_PCT_AUTO || mode > TASK_PCT_STREAM)
+        return EINVAL;
+
+    last  = tpar->rt_n;
+    first = rt_store_first(&(tpar->rt_values), last);
+    if (mode == TASK_PCT_AUTO)
+        mode = (first < last && tpar->rt_values.mode != RT_STORE_NONE)
+                   ? TASK_PCT_EXACT
+                   : TASK_PCT_STREAM;
+
+    if (mode == TASK_PCT_STREAM) {
+        if (!tpar->rt_hist.count || tpar->rt_hist.n == 0)
+            return ENODATA;
+        for (i = 0; i < n; i++) {
+            k     = pct_rank(q[i], tpar->rt_hist.n);
+            rt[i] = pct_hist_value(&(tpar->rt_hist), k) / NSEC_PER_MSEC;
+            /* The extremes are known exactly */
+            rt[i] = fmin(fmax(rt[i], tpar->rt_min), tpar->rt_max);
+            if (k == 1)
+                rt[i] = tpar->rt_min;
+            if (k == tpar->rt_hist.n)
+                rt[i] = tpar->rt_max;
+        }
+        return 0;
+    }
 
-    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (first >= last || tpar->rt_values.mode == RT_STORE_NONE)
+        return ENODATA;
 
-    if (time_cmp(now, tp[j].dl_a) > 0) {
-        tp[j].dm++;
-        return 1;
+    v = malloc((last - first) * sizeof(*v));
+    if (!v)
+        return ENOMEM;
+
+    n_v = 0;
+    for (m = first; m < last; m += len) {
+        span = rt_store_span(&(tpar->rt_values), m, last, &len);
+        if (span) {
+            memcpy(v + n_v, span, len * sizeof(*v));
+            n_v += len;
+        }
     }
 
-    return 0;
+    ret = 0;
+    if (n_v == 0)
+        ret = ENODATA;
+    else if (pct_select(v, n_v, q, rt, n) < 0)
+        ret = ENOMEM;
+    free(v);
+
+    return ret;
 }
 //-----------------------------------------------------------------------------
 
 
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
-    TASK_GET_DEADLINE_MISS: Retrieve the current amount of deadline misses for
-                            the j-th task
+    TASK_GET_WIN_COUNT: Get the number of activations of the j-th task in its
+                        sliding window (see win_len in task_attr_init)
 _____________________________________________________________________________*/
 
-int task_get_deadline_miss(int j) { return tp[j].dm; }
+unsigned long task_get_win_count(int j)
+{
+    return rt_window_count(&(TP(j)->win));
+}
 //-----------------------------------------------------------------------------
 
 
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
-    TASK_SET_DEADLINE_MISS: Set the current amount of deadline misses for the
-                            j-th task to dm
+    TASK_GET_WIN_RT_AVG:    Get the average response time of the j-th task
+                            over its sliding window, in [ms] (0 if empty)
 _____________________________________________________________________________*/
 
-int task_set_deadline_miss(int j, int dm)
+double task_get_win_rt_avg(int j) { return rt_window_avg(&(TP(j)->win)); }
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_WIN_RT_MAX:    Get the maximum response time of the j-th task
+                            over its sliding window, in [ms] (0 if empty)
+_____________________________________________________________________________*/
+
+double task_get_win_rt_max(int j) { return rt_window_max(&(TP(j)->win)); }
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_WIN_RT_MIN:    Get the minimum response time of the j-th task
+                            over its sliding window, in [ms] (0 if empty)
+_____________________________________________________________________________*/
+
+double task_get_win_rt_min(int j) { return rt_window_min(&(TP(j)->win)); }
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_WIN_RT_STD:    Get the standard deviation of the response time
+                            of the j-th task over its sliding window, in [ms]
+_____________________________________________________________________________*/
+
+double task_get_win_rt_std(int j) { return rt_window_std(&(TP(j)->win)); }
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_WIN_DM:    Get the number of deadline misses of the j-th task
+                        over its sliding window
+_____________________________________________________________________________*/
+
+unsigned long task_get_win_dm(int j) { return rt_window_dm(&(TP(j)->win)); }
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_WIN_DM_RATE:   Get the deadline misses per activation of the
+                            j-th task over its sliding window (0 if empty)
+_____________________________________________________________________________*/
+
+double task_get_win_dm_rate(int j)
 {
-    assert(dm >= 0);
-    tp[j].dm = dm;
+    unsigned long n;  // activations in the window
+
+    n = rt_window_count(&(TP(j)->win));
+
+    return n > 0 ? (double)rt_window_dm(&(TP(j)->win)) / n : 0;
 }
 //-----------------------------------------------------------------------------
 
 
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
-    TASK_WAIT_FOR_PERIOD:   Suspend the calling thread until the next
-                            activation and, when awaken, update activation time
-                            and absolute deadline
+    TASK_GET_WIN_UTIL:  Get the average utilization factor of the j-th task
+                        over its sliding window (average response time over
+                        the period)
 _____________________________________________________________________________*/
 
-void task_wait_for_period(int j)
+double task_get_win_util(int j)
 {
-    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &(tp[j].at), NULL);
-    time_add_ms(&(tp[j].at), tp[j].per);
-    time_add_ms(&(tp[j].dl_a), tp[j].per);
+    return rt_window_avg(&(TP(j)->win)) * NSEC_PER_MSEC / TP(j)->per_ns;
 }
 //-----------------------------------------------------------------------------
 
 
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
-    TASK_WAIT_FOR_END:  Join the j-th task and free the response time arrays
+    TASK_GET_EXEC_COUNT:    Get the number of execution times recorded for
+                            the j-th task (see task_update_exec)
 _____________________________________________________________________________*/
 
-int task_wait_for_end(int j)
-{
-    int rc;  // pthread_join return code (0 in case of success)
+unsigned long task_get_exec_count(int j) { return TP(j)->exec_n; }
+//-----------------------------------------------------------------------------
 
-    assert(j < NT);
-    assert(j >= 0);
 
-    rc = pthread_join(tid[j], NULL);
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_EXEC_LAST: Get the last execution time of the j-th task, in [ns]
+_____________________________________________________________________________*/
 
-    free(tp[j].rt_values);
-    free(tp[j].rt_indexes);
+int64_t task_get_exec_last(int j) { return TP(j)->exec_last; }
+//-----------------------------------------------------------------------------
 
-    return rc;
-}
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_EXEC_MIN:  Get the minimum execution time of the j-th task, in
+                        [ns] (INT64_MAX if none has been recorded yet)
+_____________________________________________________________________________*/
+
+int64_t task_get_exec_min(int j) { return TP(j)->exec_min; }
 //-----------------------------------------------------------------------------
 
 
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
-    TASK_GET_RT_AVG:    Get j-th task average response time
+    TASK_GET_EXEC_MAX:  Get the maximum execution time of the j-th task (its
+                        observed WCET), in [ns]
 _____________________________________________________________________________*/
 
-double task_get_rt_avg(int j) { return tp[j].rt_avg; };
+int64_t task_get_exec_max(int j) { return TP(j)->exec_max; }
 //-----------------------------------------------------------------------------
 
 
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
-    TASK_GET_RT_MAX:    Get j-th task maximum response time
+    TASK_GET_EXEC_AVG:  Get the average execution time of the j-th task, in
+                        [ns]
 _____________________________________________________________________________*/
 
-double task_get_rt_max(int j) { return tp[j].rt_max; };
+double task_get_exec_avg(int j) { return TP(j)->exec_mean; }
 //-----------------------------------------------------------------------------
 
 
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
-    TASK_GET_RT_MIN:    Get j-th task minimum response time
+    TASK_GET_CPU_UTIL:  Get the CPU utilization of the j-th task, i.e., its
+                        average execution time over its period (unlike
+                        util_avg, it does not count the preemptions)
 _____________________________________________________________________________*/
 
-double task_get_rt_min(int j) { return tp[j].rt_min; };
+double task_get_cpu_util(int j)
+{
+    return TP(j)->exec_mean / TP(j)->per_ns;
+}
 //-----------------------------------------------------------------------------
 
 
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
-    TASK_GET_RT_TOT:    Get j-th task summation of response times
+    TASK_GET_CPU_UTIL_MAX:  Get the maximum CPU utilization of the j-th
+                            task, i.e., its maximum execution time over its
+                            period
 _____________________________________________________________________________*/
 
-double task_get_rt_tot(int j) { return tp[j].rt_tot; };
+double task_get_cpu_util_max(int j)
+{
+    return (double)TP(j)->exec_max / TP(j)->per_ns;
+}
 //-----------------------------------------------------------------------------
 
 
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
-    TASK_GET_RT_STD:    Get j-th task standard deviation of response times
+    TASK_GET_PERF_AVAIL:    Get the bit mask of the performance counters
+                            open on the j-th task thread (bit e for the
+                            counter PERF_* e; see attr->perf): 0 if none could
+                            be opened (or none was asked for)
 _____________________________________________________________________________*/
 
-double task_get_rt_std(int j) { return tp[j].rt_std; };
+unsigned task_get_perf_avail(int j) { return TP(j)->perf_avail; }
 //-----------------------------------------------------------------------------
 
 
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
-    TASK_GET_UTIL_INST: Get j-th task instantaneous utilization factor
+    TASK_GET_PERF_COUNT:    Get the number of activations of the j-th task
+                            whose performance counters were recorded
 _____________________________________________________________________________*/
 
-double task_get_util_inst(int j) { return tp[j].util_inst; };
+unsigned long task_get_perf_count(int j) { return TP(j)->perf_n; }
 //-----------------------------------------------------------------------------
 
 
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
-    TASK_GET_UTIL_INST_MAX: Get j-th task maximum instantaneous utilization
-                            factor
+    TASK_GET_PERF_LAST: Get the count of the event (PERF_*) in the last
+                        activation of the j-th task, or -1 if its counter is
+                        not available
 _____________________________________________________________________________*/
 
-double task_get_util_inst_max(int j) { return tp[j].util_inst_max; };
+int64_t task_get_perf_last(int j, int event)
+{
+    assert(event >= 0 && event < PERF_N);
+
+    if (!(TP(j)->perf_avail & (1U << event)))
+        return -1;
+
+    return (int64_t)TP(j)->perf_last[event];
+}
 //-----------------------------------------------------------------------------
 
 
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
-    TASK_GET_UTIL_AVG:  Get j-th task average utilization factor
+    TASK_GET_PERF_MAX:  Get the maximum count of the event (PERF_*) in an
+                        activation of the j-th task, or -1 if its counter is
+                        not available
 _____________________________________________________________________________*/
 
-double task_get_util_avg(int j) { return tp[j].util_avg; };
+int64_t task_get_perf_max(int j, int event)
+{
+    assert(event >= 0 && event < PERF_N);
+
+    if (!(TP(j)->perf_avail & (1U << event)))
+        return -1;
+
+    return (int64_t)TP(j)->perf_max[event];
+}
 //-----------------------------------------------------------------------------
 
 
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
-    TASK_GET_RT_VALUES: Get the response time values array of the j-th task
+    TASK_GET_PERF_AVG:  Get the average count of the event (PERF_*) in an
+                        activation of the j-th task, or NAN if its counter is
+                        not available
 _____________________________________________________________________________*/
 
-double *task_get_rt_values(int j) { return tp[j].rt_values; };
+double task_get_perf_avg(int j, int event)
+{
+    assert(event >= 0 && event < PERF_N);
+
+    if (!(TP(j)->perf_avail & (1U << event)))
+        return NAN;
+
+    return TP(j)->perf_mean[event];
+}
 //-----------------------------------------------------------------------------
 
 
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
-    TASK_GET_RT_INDEXES:    Get the response time indexes array of the j-th task
+    TASK_GET_WD_COUNT:  Get the number of deadline misses of the j-th task
+                        caught by its watchdog, i.e., counted when the
+                        deadline passed (see attr->watchdog); they are
+                        included in the deadline misses
 _____________________________________________________________________________*/
 
-unsigned long *task_get_rt_indexes(int j) { return tp[j].rt_indexes; };
+unsigned long task_get_wd_count(int j) { return TP(j)->wd_n; }
 //-----------------------------------------------------------------------------
 
 
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
-    TASK_GET_RT_VALUE:  Get the m-th response time value of the j-th task
+    TASK_GET_WD_OVERRUN_LAST:   Get by how much the last job of the j-th task
+                                caught by its watchdog overran its deadline,
+                                in [ns]
 _____________________________________________________________________________*/
 
-double task_get_rt_value(int j, unsigned long m) { return tp[j].rt_values[m]; };
+int64_t task_get_wd_overrun_last(int j)
+{
+    return TP(j)->wd_ovr_last;
+}
 //-----------------------------------------------------------------------------
 
 
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
-    TASK_GET_RT_INDEX:  Get the m-th response time index of the j-th task
+    TASK_GET_WD_OVERRUN_MAX:    Get the maximum overrun of the deadline of a
+                                job of the j-th task caught by its watchdog,
+                                in [ns]
 _____________________________________________________________________________*/
 
-unsigned long task_get_rt_index(int j, unsigned long m)
+int64_t task_get_wd_overrun_max(int j)
 {
-    return tp[j].rt_indexes[m];
-};
+    return TP(j)->wd_ovr_max;
+}
 //-----------------------------------------------------------------------------
 
 
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
-    TASK_GET_EX_TOT:    Get the (total) number of executions for the j-th task
+    TASK_GET_CPU:   Get the CPU the j-th task ran its last activation on (-1
+                    if it has not started yet)
+_____________________________________________________________________________*/
+
+int task_get_cpu(int j) { return TP(j)->cpu; }
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_GET_MIGRATIONS:    Get the number of times the j-th task has been
+                            found on a different CPU when waking up for a new
+                            activation (see task_wait_for_period)
 _____________________________________________________________________________*/
 
-unsigned long task_get_ex_tot(int j) { return tp[j].ex_tot; };
+unsigned long task_get_migrations(int j) { return TP(j)->migr; }
 //-----------------------------------------------------------------------------
 
 
@@ -371,7 +2645,7 @@ _____________________________________________________________________________*/
 void task_set_rt_avg(int j, double rt_avg)
 {
     assert(rt_avg >= 0);
-    tp[j].rt_avg = rt_avg;
+    TP(j)->rt_avg = rt_avg;
 };
 //-----------------------------------------------------------------------------
 
@@ -383,7 +2657,7 @@ _____________________________________________________________________________*/
 void task_set_rt_max(int j, double rt_max)
 {
     assert(rt_max >= 0);
-    tp[j].rt_max = rt_max;
+    TP(j)->rt_max = rt_max;
 };
 //-----------------------------------------------------------------------------
 
@@ -395,32 +2669,54 @@ _____________________________________________________________________________*/
 void task_set_rt_min(int j, double rt_min)
 {
     assert(rt_min >= 0);
-    tp[j].rt_min = rt_min;
+    TP(j)->rt_min = rt_min;
 };
 //-----------------------------------------------------------------------------
 
 
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
     TASK_SET_RT_TOT:    Set j-th task summation of response times to rt_tot
+                        Note: setting it to 0 also resets the running
+                        mean/variance accumulators (see task_increment_rt_tot)
 _____________________________________________________________________________*/
 
 void task_set_rt_tot(int j, double rt_tot)
 {
     assert(rt_tot >= 0);
-    tp[j].rt_tot = rt_tot;
+    TP(j)->rt_tot = rt_tot;
+    if (rt_tot == 0) {
+        TP(j)->rt_n    = 0;
+        TP(j)->rt_mean = 0;
+        TP(j)->rt_m2   = 0;
+    }
 };
 //-----------------------------------------------------------------------------
 
 
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
     TASK_INCREMENT_RT_TOT:  Increment j-th task summation of response times by
-                            rt_value
-                            Note: a negative value decreases it by |rt_value|
+                            rt_value, and account for rt_value as a new sample
+                            in the running mean and variance (Welford's online
+                            algorithm), so that both task_compute_rt_avg and
+                            task_compute_std_dev take O(1)
+                            Note: a negative value decreases it by |rt_value|,
+                            but it is not removed from the running mean and
+                            variance
 _____________________________________________________________________________*/
 
 void task_increment_rt_tot(int j, double rt_value)
 {
-    tp[j].rt_tot += rt_value;
+    double delta;  // distance of the new sample from the old mean
+
+    TP(j)->rt_tot += rt_value;
+
+    if (rt_value < 0)
+        return;
+
+    TP(j)->rt_n++;
+    delta = rt_value - TP(j)->rt_mean;
+    TP(j)->rt_mean += delta / TP(j)->rt_n;
+    TP(j)->rt_m2 += delta * (rt_value - TP(j)->rt_mean);
 };
 //-----------------------------------------------------------------------------
 
@@ -433,7 +2729,7 @@ _____________________________________________________________________________*/
 void task_set_rt_std(int j, double rt_std)
 {
     assert(rt_std >= 0);
-    tp[j].rt_std = rt_std;
+    TP(j)->rt_std = rt_std;
 };
 //-----------------------------------------------------------------------------
 
@@ -446,7 +2742,7 @@ _____________________________________________________________________________*/
 void task_set_util_inst(int j, double util_inst)
 {
     assert(util_inst >= 0);
-    tp[j].util_inst = util_inst;
+    TP(j)->util_inst = util_inst;
 }
 //-----------------------------------------------------------------------------
 
@@ -459,7 +2755,7 @@ _____________________________________________________________________________*/
 void task_set_util_inst_max(int j, double util_inst_max)
 {
     assert(util_inst_max >= 0);
-    tp[j].util_inst_max = util_inst_max;
+    TP(j)->util_inst_max = util_inst_max;
 }
 //-----------------------------------------------------------------------------
 
@@ -471,7 +2767,7 @@ _____________________________________________________________________________*/
 void task_set_util_avg(int j, double util_avg)
 {
     assert(util_avg >= 0);
-    tp[j].util_avg = util_avg;
+    TP(j)->util_avg = util_avg;
 }
 //-----------------------------------------------------------------------------
 
@@ -486,9 +2782,9 @@ void task_set_rt_values(int j, double rt_values[], unsigned long dim)
     unsigned long l;  // for-loop index
 
     assert(dim > 0);
-    assert(dim <= GOOGOL);
+    assert(dim <= rt_store_limit(&(TP(j)->rt_values)));
     for (l = 0; l < dim; l++)
-        tp[j].rt_values[l] = rt_values[l];
+        task_set_rt_value(j, l, rt_values[l]);
 };
 //-----------------------------------------------------------------------------
 
@@ -503,24 +2799,32 @@ void task_set_rt_indexes(int j, unsigned long rt_indexes[], unsigned long dim)
     unsigned long l;  // for-loop index
 
     assert(dim > 0);
-    assert(dim <= GOOGOL);
+    assert(dim <= rt_store_limit(&(TP(j)->rt_indexes)));
     for (l = 0; l < dim; l++)
-        tp[j].rt_indexes[l] = rt_indexes[l];
+        task_set_rt_index(j, l, rt_indexes[l]);
 };
 //-----------------------------------------------------------------------------
 
 
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
     TASK_SET_RT_VALUE:  Set the m-th response time value for the j-th task
-                        to rt_value
+                        to rt_value; it also becomes the last response time
+                        used by the task_compute_* functions (even when the
+                        storage mode does not keep it)
 _____________________________________________________________________________*/
 
 void task_set_rt_value(int j, unsigned long m, double rt_value)
 {
+    double *slot;
+
     assert(m >= 0);
-    assert(m < GOOGOL);
+    assert(m < rt_store_limit(&(TP(j)->rt_values)));
     assert(rt_value >= 0);
-    tp[j].rt_values[m] = rt_value;
+
+    slot = (double *)rt_store_slot(&(TP(j)->rt_values), m);
+    if (slot)
+        *slot = rt_value;
+    TP(j)->rt_last = rt_value;
 };
 //-----------------------------------------------------------------------------
 
@@ -532,10 +2836,15 @@ _____________________________________________________________________________*/
 
 void task_set_rt_index(int j, unsigned long m, unsigned long rt_index)
 {
+    unsigned long *slot;
+
     assert(m >= 0);
-    assert(m < GOOGOL);
+    assert(m < rt_store_limit(&(TP(j)->rt_indexes)));
     assert(rt_index >= 0);
-    tp[j].rt_indexes[m] = rt_index;
+
+    slot = (unsigned long *)rt_store_slot(&(TP(j)->rt_indexes), m);
+    if (slot)
+        *slot = rt_index;
 };
 //-----------------------------------------------------------------------------
 
@@ -548,8 +2857,8 @@ _____________________________________________________________________________*/
 void task_set_ex_tot(int j, unsigned long m)
 {
     assert(m >= 0);
-    assert(m < GOOGOL);
-    tp[j].ex_tot = m;
+    assert(m < rt_store_limit(&(TP(j)->rt_values)));
+    TP(j)->ex_tot = m;
 };
 //-----------------------------------------------------------------------------
 
@@ -560,16 +2869,14 @@ _____________________________________________________________________________*/
 
 double task_compute_rt_max(int j)
 {
-    unsigned long m;
-    double        rt_value;  // last response time value
-    double        rt_max;
+    double rt_value;  // last response time value
+    double rt_max;
 
-    m        = tp[j].ex_tot;
-    rt_value = tp[j].rt_values[m];
-    rt_max   = tp[j].rt_max;
+    rt_value = TP(j)->rt_last;
+    rt_max   = TP(j)->rt_max;
 
     rt_max = fmax(rt_value, rt_max);
-    // return fmax(tp[j].rt_values[tp[j].ex_tot], tp[j].rt_max); // shorter way
+    // return fmax(TP(j)->rt_last, TP(j)->rt_max); // shorter way
 
     return rt_max;
 }
@@ -578,24 +2885,27 @@ double task_compute_rt_max(int j)
 
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
     TASK_COMPUTE_RT_MAX_FROM_SCRATCH:   Compute maximum response time of the
-                                        j-th task from scratch
+                                        j-th task from scratch, over the
+                                        stored response times (if none is
+                                        stored, return the current rt_max)
 _____________________________________________________________________________*/
 
 double task_compute_rt_max_from_scratch(int j)
 {
-    unsigned long m;
-    unsigned long ex_tot;
-    double       *rt_values;
-    double        rt_max;
+    unsigned long    m;
+    unsigned long    ex_tot;
+    struct rt_reduce r;  // reduction of the stored response times
 
-    ex_tot    = tp[j].ex_tot;
-    rt_values = tp[j].rt_values;
-    rt_max    = 0;
+    ex_tot = TP(j)->ex_tot;
+    m      = rt_store_first(&(TP(j)->rt_values), ex_tot + 1);
 
-    for (m = 0; m < ex_tot; m++)
-        rt_max = fmax(rt_values[m], rt_max);
+    if (TP(j)->rt_values.mode == RT_STORE_NONE)
+        return TP(j)->rt_max;
 
-    return rt_max;
+    rt_reduce_init(&r);
+    rt_reduce_store(&(TP(j)->rt_values), m, ex_tot, 0, &r);
+
+    return fmax(r.max, 0);
 }
 //-----------------------------------------------------------------------------
 
@@ -606,16 +2916,14 @@ _____________________________________________________________________________*/
 
 double task_compute_rt_min(int j)
 {
-    unsigned long m;
-    double        rt_value;  // last response time value
-    double        rt_min;
+    double rt_value;  // last response time value
+    double rt_min;
 
-    m        = tp[j].ex_tot;
-    rt_value = tp[j].rt_values[m];
-    rt_min   = tp[j].rt_min;
+    rt_value = TP(j)->rt_last;
+    rt_min   = TP(j)->rt_min;
 
     rt_min = fmin(rt_value, rt_min);
-    // return fmin(tp[j].rt_values[tp[j].ex_tot], tp[j].rt_min); // shorter way
+    // return fmin(TP(j)->rt_last, TP(j)->rt_min); // shorter way
 
     return rt_min;
 }
@@ -624,56 +2932,89 @@ double task_compute_rt_min(int j)
 
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
     TASK_COMPUTE_RT_MIN_FROM_SCRATCH:   Compute minimum response time of the
-                                        j-th task from scratch
+                                        j-th task from scratch, over the
+                                        stored response times (if none is
+                                        stored, return the current rt_min)
 _____________________________________________________________________________*/
 
 double task_compute_rt_min_from_scratch(int j)
 {
-    unsigned long m;
-    unsigned long ex_tot;
-    double       *rt_values;
-    double        rt_min;
+    unsigned long    m;
+    unsigned long    ex_tot;
+    struct rt_reduce r;  // reduction of the stored response times
 
-    ex_tot    = tp[j].ex_tot;
-    rt_values = tp[j].rt_values;
-    rt_min    = DBL_MAX;
+    ex_tot = TP(j)->ex_tot;
+    m      = rt_store_first(&(TP(j)->rt_values), ex_tot + 1);
 
-    for (m = 0; m < ex_tot; m++)
-        rt_min = fmin(rt_values[m], rt_min);
+    if (TP(j)->rt_values.mode == RT_STORE_NONE)
+        return TP(j)->rt_min;
 
-    return rt_min;
+    rt_reduce_init(&r);
+    rt_reduce_store(&(TP(j)->rt_values), m, ex_tot, 0, &r);
+
+    return r.min;
 }
 //-----------------------------------------------------------------------------
 
 
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
     TASK_COMPUTE_STD_DEV:   Compute standard deviation of the response time of
-                            the j-th task
+                            the j-th task in O(1), from the running variance
+                            updated by task_increment_rt_tot
 _____________________________________________________________________________*/
 
 double task_compute_std_dev(int j)
 {
-    double       *rt_values;
-    unsigned long m;
-    double        rt_avg;
-    unsigned long l;            // for-loop index
-    double        squares_sum;  // summation of (x - x_avg)^2
-    double        rt_std;       // standard deviation
+    unsigned long n;  // number of samples
+    double        rt_std;
+
+    n = TP(j)->rt_n;
+
+    if (n < 2)  // When there is only one sample:
+        return DBL_MAX;
+
+    /* Corrected sample standard deviation (Bessel's correction) */
+    rt_std = sqrt(TP(j)->rt_m2 / (n - 1));
 
-    rt_values   = tp[j].rt_values;
-    m           = tp[j].ex_tot;
-    rt_avg      = tp[j].rt_avg;
-    squares_sum = 0;
+    return rt_std;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK_COMPUTE_STD_DEV_FROM_SCRATCH:  Compute standard deviation of the
+                                        response time of the j-th task from
+                                        scratch, over the stored response
+                                        times (if none is stored, return the
+                                        current rt_std)
+_____________________________________________________________________________*/
+
+double task_compute_std_dev_from_scratch(int j)
+{
+    unsigned long    m;
+    unsigned long    first;   // index of the oldest stored sample
+    double           rt_avg;
+    struct rt_reduce r;       // reduction of the stored response times
+    double           rt_std;  // standard deviation
+
+    m      = TP(j)->ex_tot;
+    first  = rt_store_first(&(TP(j)->rt_values), m + 1);
+    rt_avg = TP(j)->rt_avg;
 
     if (m == 0)  // When there is only one sample:
         return DBL_MAX;
-    for (l = 0; l < m; l++)
-        squares_sum += pow((rt_values[l] - rt_avg), 2);
+    if (first >= m)
+        return TP(j)->rt_std;
+
+    /* The squares are summed around rt_avg, i.e., summation of
+       (x - x_avg)^2 */
+    rt_reduce_init(&r);
+    rt_reduce_store(&(TP(j)->rt_values), first, m, rt_avg, &r);
 
     /* Estimate the standard deviation using the corrected sample standard
        deviation (dividing by N_samples - 1 = m rather than by N_samples = m
        + 1, i.e., using the Bessel's correction) */
-    rt_std = sqrt(squares_sum / m);
+    rt_std = sqrt(r.sumsq / (m - first));
 
     return rt_std;
 }
@@ -687,17 +3028,15 @@ _____________________________________________________________________________*/
 
 double task_compute_util_inst(int j)
 {
-    double        rt_current;  // current response time
-    unsigned long m;           // number of task executions
-    int           per;         // task period
-    double        util_inst;   /* instantaneous utilization factor; value
-                                  (hopefully) in [0, 1] */
+    double rt_current;  // current response time                         [ms]
+    double per;         // task period                                   [ms]
+    double util_inst;   /* instantaneous utilization factor; value
+                           (hopefully) in [0, 1] */
 
-    m          = tp[j].ex_tot;
-    rt_current = tp[j].rt_values[m];
-    per        = tp[j].per;
+    rt_current = TP(j)->rt_last;
+    per        = (double)(TP(j)->per_ns) / NSEC_PER_MSEC;
 
-    util_inst = rt_current / (double)(per);
+    util_inst = rt_current / per;
 
     return util_inst;
 }
@@ -711,17 +3050,17 @@ _____________________________________________________________________________*/
 
 double task_compute_util_inst_max(int j)
 {
-    double rt_max;        // maximum response time
-    int    per;           // task period
+    double rt_max;        // maximum response time                       [ms]
+    double per;           // task period                                 [ms]
     double util_inst_max; /* maximum instantaneous utilization factor;
                              value (hopefully) in [0, 1] */
     double util_inst;     /* instantaneous utilization factor; value
                              (hopefully) in [0, 1] */
 
-    rt_max = tp[j].rt_max;
-    per    = tp[j].per;
+    rt_max = TP(j)->rt_max;
+    per    = (double)(TP(j)->per_ns) / NSEC_PER_MSEC;
 
-    util_inst_max = rt_max / (double)(per);
+    util_inst_max = rt_max / per;
     // util_inst_max = fmax(util_inst, util_inst_max);   // alternative way
 
     return util_inst_max;
@@ -737,15 +3076,15 @@ double task_compute_util_avg(int j)
 {
     double        rt_tot;
     unsigned long m;
-    int           per;
+    double        per;      // task period                               [ms]
     double        util_avg; /* average utilization factor; value
                                (hopefully) in [0, 1] */
 
-    rt_tot = tp[j].rt_tot;
-    m      = tp[j].ex_tot;
-    per    = tp[j].per;
+    rt_tot = TP(j)->rt_tot;
+    m      = TP(j)->ex_tot;
+    per    = (double)(TP(j)->per_ns) / NSEC_PER_MSEC;
 
-    util_avg = rt_tot / (double)((m + 1) * per);
+    util_avg = rt_tot / ((m + 1) * per);
 
     return util_avg;
 }
@@ -753,7 +3092,10 @@ double task_compute_util_avg(int j)
 
 
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
-    TASK_COMPUTE_RT_AVG:    Compute average response time of the j-th task
+    TASK_COMPUTE_RT_AVG:    Compute average response time of the j-th task,
+                            i.e., the running mean updated by
+                            task_increment_rt_tot (or rt_tot / (ex_tot + 1) if
+                            rt_tot was set by task_set_rt_tot only)
 _____________________________________________________________________________*/
 
 double task_compute_rt_avg(int j)
@@ -762,8 +3104,11 @@ double task_compute_rt_avg(int j)
     double        rt_avg;  // average response time
     unsigned long m;
 
-    rt_tot = tp[j].rt_tot;
-    m      = tp[j].ex_tot;
+    if (TP(j)->rt_n > 0)
+        return TP(j)->rt_mean;
+
+    rt_tot = TP(j)->rt_tot;
+    m      = TP(j)->ex_tot;
 
     rt_avg = rt_tot / (m + 1);
 
@@ -774,25 +3119,28 @@ double task_compute_rt_avg(int j)
 
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
     TASK_COMPUTE_RT_AVG_FROM_SCRATCH:   Compute average response time of the
-                                        j-th task from scratch
+                                        j-th task from scratch, over the
+                                        stored response times (if none is
+                                        stored, return the current rt_avg)
 _____________________________________________________________________________*/
 
 double task_compute_rt_avg_from_scratch(int j)
 {
-    unsigned long m;
-    unsigned long ex_tot;
-    double       *rt_values;
-    double        rt_tot;
-    double        rt_avg;  // average response time
+    unsigned long    first;   // index of the oldest stored sample
+    unsigned long    ex_tot;
+    struct rt_reduce r;       // reduction of the stored response times
+    double           rt_avg;  // average response time
+
+    ex_tot = TP(j)->ex_tot;
+    first  = rt_store_first(&(TP(j)->rt_values), ex_tot + 1);
 
-    ex_tot    = tp[j].ex_tot;
-    rt_values = tp[j].rt_values;
-    rt_tot    = 0;
+    if (first == ex_tot + 1)
+        return TP(j)->rt_avg;
 
-    for (m = 0; m <= ex_tot; m++)
-        rt_tot += tp[j].rt_values[m];
+    rt_reduce_init(&r);
+    rt_reduce_store(&(TP(j)->rt_values), first, ex_tot + 1, 0, &r);
 
-    rt_avg = rt_tot / (ex_tot + 1);
+    rt_avg = r.sum / (ex_tot + 1 - first);
 
     return rt_avg;
 }
@@ -14,18 +14,45 @@ _____________________________________________________________________________*/
 #define EASY_PTHREAD_TASK_H
 
 #include <pthread.h>
+#include <sys/types.h>
+#include "easy_pthread_analysis.h"
+#include "easy_pthread_pct.h"
+#include "easy_pthread_perf.h"
+#include "easy_pthread_store.h"
 #include "easy_pthread_time.h"
+#include "easy_pthread_window.h"
 
 
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
     GLOBAL CONSTANTS
 _____________________________________________________________________________*/
-#define NT     20          // maximum possible number of tasks
-#define GOOGOL 10000000    // maximum possible length of response time arrays
+#define NT     20          /* former maximum possible number of tasks; kept
+                              for compatibility, it is not a limit anymore */
+#define TASK_MAX 65536     // maximum possible number of tasks
+#define GOOGOL 10000000    // default maximum length of response time arrays
                            /* e.g.: GOOGOL = 10000000 and task_period = 20 ms
                                     can guarantee more than 55 hours of response
-                                    time data recording */
+                                    time data recording; memory is only
+                                    allocated as the samples get recorded */
 #define LINUX_MAX_PRIO 99  // highest priority level allowed in Linux       []
+#define CACHE_LINE     64  // size of a cache line                        [byte]
+
+#define CACHE_ALIGNED __attribute__((aligned(CACHE_LINE)))
+
+#define TASK_PLACE_NONE 0  // the task may run on any CPU of the cpus set
+#define TASK_PLACE_AUTO 1  // the task is pinned to the least loaded CPU
+
+#define TASK_OVERRUN_CATCHUP 0  // run the missed activations back-to-back
+#define TASK_OVERRUN_SKIP    1  // skip to the next activation in the future
+#define TASK_OVERRUN_REPHASE 2  // activate now, and shift the next ones
+
+#define TASK_PCT_AUTO   0  // exact if the response times are stored
+#define TASK_PCT_EXACT  1  // selection over the stored response times
+#define TASK_PCT_STREAM 2  // streaming histogram (see attr->rt_hist)
+
+#ifndef SCHED_DEADLINE
+#define SCHED_DEADLINE 6  // Linux EDF + CBS policy (sched_setattr only)
+#endif
 //-----------------------------------------------------------------------------
 
 
@@ -36,14 +63,70 @@ _____________________________________________________________________________*/
 //-----------------------------------------------------------------------------
 /* Real-Time parameters */
 /* Such a structure must be initialized before calling the thread_create and
-   passed as a thread argument. A structure for each thread is required. */
+   passed as a thread argument. A structure for each thread is required.
+   Its fields are split in two blocks:
+       * a cold block, holding the configuration of the task, which is only
+         written when the task is created or joined
+       * a hot block, starting on its own cache line, holding the state
+         written by the task thread at each activation
+   Since every task_par is allocated on its own (cache-line-aligned) memory,
+   and its size is a multiple of CACHE_LINE, tasks running on different cores
+   never write to the same cache line (i.e., no false sharing). */
 struct task_par
 {
-    int            ind;        // task index; value in {0, ..., NT - 1}
-    int            per;        // task period                               [ms]
-    int            dl_r;       // relative deadline                         [ms]
+    // Cold block ------------------------------------------------------------
+    int            ind;        // task index; value in {0, ..., TASK_MAX - 1}
+    int            per;        // task period (rounded down)                [ms]
+    int            dl_r;       // relative deadline (rounded down)          [ms]
+    int64_t        per_ns;     // task period                               [ns]
+    int64_t        dl_r_ns;    // relative deadline                         [ns]
     int            pri;        // task priority; value in {1, ..., 99}
+    int            policy;     // scheduling policy in use (SCHED_*)
+    int64_t        runtime_ns; // SCHED_DEADLINE runtime; 0 if not used    [ns]
+    int64_t        wcet_ns;    // declared WCET; 0 to use rt_max           [ns]
+    int64_t        wcrt_ns;    // WCRT from the last analysis, or -1       [ns]
+    int            cpu_pin;    // CPU the task is pinned to, or -1
+    int            stop;       // 1 when task_run_periodic must return
+    int            overrun;    // overrun policy (TASK_OVERRUN_*)
+    int            exec_time;  // 1 if the execution times are measured
+    int            perf;       // 1 to open the counters on the task thread
+    unsigned       perf_avail; // bit mask of the open counters (PERF_*)
+    struct perf_ctr perf_ctr;  // counters of the task thread
+    int            watchdog;   // 1 to open the watchdog on the task thread
+    int            wd_fd;      // watchdog timer, or -1
+    void         (*wd_handler)(int j);  // called by the watchdog, or NULL
+    struct shm_stats_slot *shm;    // shared-memory statistics, or NULL
+    struct rt_store rt_values;     // store of all the response times       [ms]
+    struct rt_store rt_indexes;    // store of the indexes of the rt
+    struct rt_store lat_values;    // store of the wake-up latencies       [ns]
+    struct pct_hist rt_hist;       // histogram of the response times      [ns]
+    void        *(*body)(void *);  // task function, run by the task thread
+    int            rt_mem;         // 1 if memory is locked and pre-faulted
+    pid_t          tid_os;         // kernel thread id of the task
+    long           pf_base;        // page faults before task_set_activation
+    long           pf_end;         // page faults taken when the task ended
+    int            pf_done;        // 1 if the task ended (pf_end is valid)
+    pthread_t      tid;            // thread of the task
+    int            used;           // 1 if the index is reserved or live
+    int            live;           // 1 if the task has been created
+    int            live_pos;       // position among the live tasks
+    int            in_free;        // 1 if the index is in the free stack
+    int            cpu_auto;       // CPU chosen by TASK_PLACE_AUTO, or -1
+
+    // Hot block -------------------------------------------------------------
+    unsigned       seq CACHE_ALIGNED;  /* statistics sequence counter; odd
+                                          while they are being updated */
+    int            seq_depth;  // nesting depth of task_stats_write_begin
     int            dm;         // number of deadline misses
+    int            cpu;        // CPU of the last activation, or -1
+    unsigned long  migr;       // number of migrations between activations
+    unsigned long  skip;       // number of activations skipped by overruns
+    int64_t        lat_last;   // last wake-up latency                      [ns]
+    int64_t        lat_min;    // minimum wake-up latency                   [ns]
+    int64_t        lat_max;    // maximum wake-up latency                   [ns]
+    unsigned long  lat_n;      // number of wake-up latencies
+    double         lat_mean;   // running mean of the wake-up latency       [ns]
+    double         lat_m2;     // running sum of squared deviations      [ns^2]
     double         rt_avg;     // average response time                     [ms]
     double         rt_max;     // maximum response time                     [ms]
     double         rt_min;     // minimum response time                     [ms]
@@ -52,10 +135,30 @@ struct task_par
     double         util_inst;  // instantaneous utilization factor
     double         util_inst_max;  // maximumm instantaneous utilization factor
     double         util_avg;       // average utilization factor
-    double        *rt_values;      // array storing all the response times  [ms]
-    unsigned long *rt_indexes;     // array storing the indexes of the rt
+    double         rt_last;        // last recorded response time           [ms]
+    unsigned long  rt_n;           // number of samples in rt_mean and rt_m2
+    double         rt_mean;        // running mean of the response time     [ms]
+    double         rt_m2;          // running sum of squared deviations  [ms^2]
+    struct rt_window win;          // window of the last response times    [ms]
+    int            win_dm;         // dm at the last window update
+    unsigned long  exec_n;         // number of execution times
+    int64_t        exec_last;      // last execution time                  [ns]
+    int64_t        exec_min;       // minimum execution time               [ns]
+    int64_t        exec_max;       // maximum execution time (observed WCET)
+    double         exec_mean;      // running mean of the execution time   [ns]
+    int            perf_run;       // 1 while an activation is counted
+    unsigned long  perf_n;         // number of counted activations
+    uint64_t       perf_base[PERF_N];  // counters at the activation start
+    uint64_t       perf_last[PERF_N];  // counts of the last activation
+    uint64_t       perf_max[PERF_N];   // maximum counts of an activation
+    double         perf_mean[PERF_N];  // running mean of the counts
+    int64_t        wd_dl;      /* absolute deadline watched by the watchdog
+                                  [ns]; 0 if none, negated once it fired */
+    unsigned long  wd_n;       // deadline misses caught by the watchdog
+    int64_t        wd_ovr_last;    // last overrun of a caught job         [ns]
+    int64_t        wd_ovr_max;     // maximum overrun of a caught job      [ns]
     unsigned long  ex_tot;         /* (current) total number of task execution;
-                                      value in {0, ..., GOOGOL - 1}.
+                                      value in {0, ..., rt_cap - 1}.
                                       Note: it starts counting from 0, not 1;
                                       hence, the actual number of execution is
                                       (ex_tot + 1) */
@@ -63,21 +166,139 @@ struct task_par
     struct timespec dl_a;          // absolute deadline
 };
 //-----------------------------------------------------------------------------
+/* Statistics snapshot */
+/* Consistent copy of the statistics of a task (see task_get_stats). */
+struct task_stats
+{
+    unsigned long ex_tot;         // (current) total number of task execution
+    int           dm;             // number of deadline misses
+    int           cpu;            // CPU of the last activation, or -1
+    unsigned long migr;           // number of migrations between activations
+    unsigned long skip;           // number of activations skipped by overruns
+    unsigned long lat_n;          // number of wake-up latencies
+    int64_t       lat_last;       // last wake-up latency                   [ns]
+    int64_t       lat_min;        // minimum wake-up latency                [ns]
+    int64_t       lat_max;        // maximum wake-up latency                [ns]
+    double        lat_avg;        // average wake-up latency                [ns]
+    double        lat_std;        // std. deviation of the wake-up latency  [ns]
+    double        rt_last;        // last recorded response time            [ms]
+    double        rt_avg;         // average response time                  [ms]
+    double        rt_max;         // maximum response time                  [ms]
+    double        rt_min;         // minimum response time                  [ms]
+    double        rt_tot;         // total response time                    [ms]
+    double        rt_std;         // std. deviation of the response time    [ms]
+    double        util_inst;      // instantaneous utilization factor
+    double        util_inst_max;  // maximum instantaneous utilization factor
+    double        util_avg;       // average utilization factor
+    unsigned long win_n;          // number of activations in the window
+    unsigned long win_dm;         // deadline misses in the window
+    double        win_rt_avg;     // average response time in the window   [ms]
+    double        win_rt_max;     // maximum response time in the window   [ms]
+    double        win_rt_min;     // minimum response time in the window   [ms]
+    double        win_rt_std;     // std. deviation in the window          [ms]
+    unsigned long exec_n;         // number of execution times
+    int64_t       exec_last;      // last execution time                   [ns]
+    int64_t       exec_min;       // minimum execution time                [ns]
+    int64_t       exec_max;       // maximum execution time (observed WCET)
+    double        exec_avg;       // average execution time                [ns]
+    double        cpu_util;       // CPU utilization (exec_avg / period)
+    unsigned long perf_n;         // number of counted activations
+    uint64_t      perf_max[PERF_N];  // maximum counts of an activation
+    double        perf_avg[PERF_N];  // average counts of an activation
+    unsigned long wd_n;           // deadline misses caught by the watchdog
+    int64_t       wd_ovr_last;    // last overrun of a caught job          [ns]
+    int64_t       wd_ovr_max;     // maximum overrun of a caught job       [ns]
+};
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+/* Optional task attributes */
+/* Such a structure must be initialized by task_attr_init, then possibly
+   modified, before being passed to task_create_ex. */
+struct task_attr
+{
+    int           rt_store;  // response time storage mode (RT_STORE_*)
+    unsigned long rt_cap;    // response time storage capacity        [samples]
+    int           rt_mem;    /* 1 to lock the process memory and pre-fault
+                                the response time store and the stack */
+    int           hugepages;   // 1 to back the rt store by huge pages
+    size_t        stack_size;  // task stack size; 0 for the default    [byte]
+    const int    *cpus;        // CPUs the task may run on; NULL for any
+    int           n_cpus;      // number of CPUs in cpus
+    int           placement;   // CPU placement policy (TASK_PLACE_*)
+    int           policy;      // SCHED_RR, SCHED_FIFO or SCHED_DEADLINE
+    int           fallback;    /* SCHED_RR or SCHED_FIFO, used if
+                                  SCHED_DEADLINE is refused */
+    int64_t       runtime_ns;  // SCHED_DEADLINE runtime budget           [ns]
+    int64_t       wcet_ns;     // declared WCET; 0 to use rt_max          [ns]
+    int           admission;   // test run at creation (ANALYSIS_*)
+    int           lat_store;   /* 1 to store the wake-up latencies too (same
+                                  mode and capacity as the response times) */
+    int           overrun;     // overrun policy (TASK_OVERRUN_*)
+    int           trace;       /* 1 to stream the activations to the trace
+                                  (see trace_open) */
+    int           rt_hist;     /* 1 to count the response times in a
+                                  histogram (streaming percentiles) */
+    unsigned long win_len;     /* sliding window length; 0 for no window
+                                                                  [samples] */
+    int64_t       win_ns;      /* sliding window span; 0 to only limit it by
+                                  win_len                                [ns] */
+    int           exec_time;   /* 1 to measure the CPU time of each
+                                  activation run by task_run_periodic (or by
+                                  the dispatcher) */
+    int           perf;        /* 1 to count the hardware events of each
+                                  activation (see perf_open); ignored by
+                                  the dispatcher jobs */
+    int           watchdog;    /* 1 to catch the deadline misses as soon as
+                                  the deadline passes (see wd_handler);
+                                  ignored by the dispatcher jobs */
+    void        (*wd_handler)(int j);  /* called by the watchdog thread when
+                                          the j-th task misses a deadline,
+                                          or NULL */
+};
+//-----------------------------------------------------------------------------
 
 
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
     FUNCTION PROTOTYPES
 _____________________________________________________________________________*/
 
+void task_attr_init(struct task_attr *attr);
+
+int task_alloc();
+
+int task_get_count();
+
 int task_create(void *(*task)(void *), int j, int per, int drel, int prio);
 
+int task_create_ex(void *(*task)(void *), int j, int per, int drel, int prio,
+                   const struct task_attr *attr);
+
+int task_create_ns(void *(*task)(void *), int j, int64_t per, int64_t drel,
+                   int prio, const struct task_attr *attr);
+
+int task_create_job(int j, int64_t per, int64_t drel, int prio,
+                    const struct task_attr *attr);
+
+void task_destroy_job(int j);
+
 int task_get_index(void *ind);
 
 int task_get_period(int j);
 
+int64_t task_get_period_ns(int j);
+
+int64_t task_get_deadline_ns(int j);
+
 int task_get_max_priority();
 
-int task_get_max_preriod();
+int task_get_policy(int j);
+
+int task_get_max_period();
+
+int task_get_max_preriod()
+    __attribute__((deprecated("use task_get_max_period")));
 
 void task_set_activation(int j);
 
@@ -87,8 +308,14 @@ int task_get_deadline_miss(int j);
 
 int task_set_deadline_miss(int j, int dm);
 
+void task_add_deadline_miss(int j, int n);
+
 void task_wait_for_period(int j);
 
+int task_run_periodic(int j, int (*body)(int j, void *ctx), void *ctx);
+
+void task_stop(int j);
+
 int task_wait_for_end(int j);
 
 double task_get_rt_avg(int j);
@@ -117,6 +344,97 @@ unsigned long task_get_rt_index(int j, unsigned long m);
 
 unsigned long task_get_ex_tot(int j);
 
+void task_get_stats(int j, struct task_stats *st);
+
+void task_stats_write_begin(int j);
+
+void task_stats_write_end(int j);
+
+void task_update_stats(int j, double rt_value);
+
+void task_update_stats_at(int j, double rt_value, int64_t end_ns);
+
+void task_update_exec(int j, int64_t exec_ns);
+
+long task_get_page_faults(int j);
+
+int task_check_schedulability(int test);
+
+int64_t task_get_wcrt_ns(int j);
+
+unsigned long task_get_skipped(int j);
+
+unsigned long task_get_lat_count(int j);
+
+int64_t task_get_lat_last(int j);
+
+int64_t task_get_lat_min(int j);
+
+int64_t task_get_lat_max(int j);
+
+double task_get_lat_avg(int j);
+
+double task_get_lat_std(int j);
+
+int64_t task_get_jitter(int j);
+
+int64_t task_get_lat_value(int j, unsigned long k);
+
+double task_get_rt_percentile(int j, double q);
+
+int task_get_rt_percentiles(int j, const double *q, double *rt, int n,
+                            int mode);
+
+unsigned long task_get_win_count(int j);
+
+double task_get_win_rt_avg(int j);
+
+double task_get_win_rt_max(int j);
+
+double task_get_win_rt_min(int j);
+
+double task_get_win_rt_std(int j);
+
+unsigned long task_get_win_dm(int j);
+
+double task_get_win_dm_rate(int j);
+
+double task_get_win_util(int j);
+
+unsigned long task_get_exec_count(int j);
+
+int64_t task_get_exec_last(int j);
+
+int64_t task_get_exec_min(int j);
+
+int64_t task_get_exec_max(int j);
+
+double task_get_exec_avg(int j);
+
+double task_get_cpu_util(int j);
+
+double task_get_cpu_util_max(int j);
+
+unsigned task_get_perf_avail(int j);
+
+unsigned long task_get_perf_count(int j);
+
+int64_t task_get_perf_last(int j, int event);
+
+int64_t task_get_perf_max(int j, int event);
+
+double task_get_perf_avg(int j, int event);
+
+unsigned long task_get_wd_count(int j);
+
+int64_t task_get_wd_overrun_last(int j);
+
+int64_t task_get_wd_overrun_max(int j);
+
+int task_get_cpu(int j);
+
+unsigned long task_get_migrations(int j);
+
 void task_set_rt_avg(int j, double rt_avg);
 
 void task_set_rt_max(int j, double rt_max);
@@ -155,6 +473,8 @@ double task_compute_rt_min_from_scratch(int j);
 
 double task_compute_std_dev(int j);
 
+double task_compute_std_dev_from_scratch(int j);
+
 double task_compute_util_inst(int j);
 
 double task_compute_util_inst_max(int j);
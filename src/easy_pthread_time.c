@@ -11,6 +11,54 @@ _____________________________________________________________________________*/
 
 
 #include "easy_pthread_time.h"
+#include <assert.h>
+#include <pthread.h>
+#if defined(__x86_64__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    LOCAL CONSTANTS
+_____________________________________________________________________________*/
+#define TSC_SHIFT    32                     // fixed-point shift of tsc.mult
+#define TSC_CALIB_MS 20                     // calibration interval       [ms]
+#define TSC_SAMPLES  8                      // tries of each TSC/clock read
+#define TSC_CHECK_NS (1000 * NSEC_PER_MSEC) // drift check period         [ns]
+#define TSC_DRIFT_PPM 1000                  // highest drift rate        [ppm]
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    STRUCTURES DEFINITION
+_____________________________________________________________________________*/
+
+/* Conversion from TSC ticks to CLOCK_MONOTONIC nanoseconds, i.e.:
+   ns = base_ns + (ticks - base_tsc) * mult / 2^TSC_SHIFT */
+struct tsc_conv {
+    uint64_t base_tsc;  // TSC value at base_ns                     [ticks]
+    int64_t  base_ns;   // CLOCK_MONOTONIC time at base_tsc            [ns]
+    uint64_t mult;      // nanoseconds per tick, << TSC_SHIFT
+};
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    GLOBAL VARIABLES (definition)
+_____________________________________________________________________________*/
+static int             time_source = TIME_SOURCE_CLOCK;  // source in use
+static struct tsc_conv tsc[2];     /* conversion from TSC ticks, latched:
+                                      readers use tsc[tsc_seq & 1] */
+static unsigned int    tsc_seq;    // latch sequence counter
+static uint64_t        ref_tsc;    // TSC value at the last clock sample
+static int64_t         ref_ns;     // CLOCK_MONOTONIC time at ref_tsc    [ns]
+static int             checker_on; // 1 while the drift checker runs
+static pthread_mutex_t tsc_lock = PTHREAD_MUTEX_INITIALIZER;  // TSC writers
+static int64_t         drift;  // TSC - CLOCK_MONOTONIC at the last check [ns]
+static int64_t       (*virtual_now)();  // virtual clock, or NULL
+static __thread int64_t tsc_last;  // highest TSC time read by the thread
+//-----------------------------------------------------------------------------
 
 
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
@@ -33,11 +81,27 @@ _____________________________________________________________________________*/
 
 void time_add_ms(struct timespec *t, int ms)
 {
-    t->tv_sec += ms / 1000;
-    t->tv_nsec += (ms % 1000) * 1000000;
-    if (t->tv_nsec > 1000000000) {
-        t->tv_nsec -= 1000000000;
+    time_add_ns(t, (int64_t)ms * NSEC_PER_MSEC);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TIME_ADD_NS:    Add a value ns (expressed in nanoseconds; possibly
+                    negative) to the time variable pointed by t, keeping
+                    tv_nsec in {0, ..., NSEC_PER_SEC - 1}
+_____________________________________________________________________________*/
+
+void time_add_ns(struct timespec *t, int64_t ns)
+{
+    t->tv_sec += ns / NSEC_PER_SEC;
+    t->tv_nsec += ns % NSEC_PER_SEC;
+    if (t->tv_nsec >= NSEC_PER_SEC) {
+        t->tv_nsec -= NSEC_PER_SEC;
         t->tv_sec += 1;
+    } else if (t->tv_nsec < 0) {
+        t->tv_nsec += NSEC_PER_SEC;
+        t->tv_sec -= 1;
     }
 }
 //-----------------------------------------------------------------------------
@@ -75,7 +139,7 @@ double timespec2ms(struct timespec t)
 {
     double t_in_ms;
 
-    t_in_ms = (double)(t.tv_sec) * 1000 + (double)(t.tv_nsec) / 1000000;
+    t_in_ms = (double)(timespec2ns(t)) / NSEC_PER_MSEC;
 
     return t_in_ms;
 }
@@ -92,8 +156,485 @@ double get_time_diff_in_ms(struct timespec *t1, struct timespec *t2)
 {
     double t_in_ms;
 
-    t_in_ms = timespec2ms(*t1) - timespec2ms(*t2);  // t1 - t2          [ms]
+    /* The difference is computed in (exact) integer nanoseconds first, so
+       that no precision is lost, even after long uptimes */
+    t_in_ms = (double)(get_time_diff_in_ns(t1, t2)) / NSEC_PER_MSEC;
 
     return t_in_ms;
 }
 //-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TIMESPEC2NS:    Convert time variable t from (struct) timespec to
+                    nanoseconds [ns]
+_____________________________________________________________________________*/
+
+int64_t timespec2ns(struct timespec t)
+{
+    return (int64_t)(t.tv_sec) * NSEC_PER_SEC + t.tv_nsec;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    NS2TIMESPEC:    Convert a (non-negative) time ns from nanoseconds [ns] to
+                    (struct) timespec
+_____________________________________________________________________________*/
+
+struct timespec ns2timespec(int64_t ns)
+{
+    struct timespec t;
+
+    t.tv_sec  = ns / NSEC_PER_SEC;
+    t.tv_nsec = ns % NSEC_PER_SEC;
+
+    return t;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    GET_TIME_DIFF_IN_NS:    Compute the difference (expressed in [ns]) between
+                            two time variables pointed by t1 and t2 (both
+                            expressed in (struct) timespec)
+_____________________________________________________________________________*/
+
+int64_t get_time_diff_in_ns(struct timespec *t1, struct timespec *t2)
+{
+    int64_t t_in_ns;
+
+    t_in_ns = (int64_t)(t1->tv_sec - t2->tv_sec) * NSEC_PER_SEC +
+              (t1->tv_nsec - t2->tv_nsec);  // t1 - t2                      [ns]
+
+    return t_in_ns;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    CLOCK_NS:   Return the current CLOCK_MONOTONIC time, in [ns]
+_____________________________________________________________________________*/
+
+static int64_t clock_ns()
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+
+    return timespec2ns(t);
+}
+//-----------------------------------------------------------------------------
+
+
+#if defined(__x86_64__)
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TSC_INVARIANT:  Return 1 if the TSC runs at a constant rate in every
+                    power state (CPUID.80000007H:EDX[8]), 0 otherwise
+_____________________________________________________________________________*/
+
+static int tsc_invariant()
+{
+    unsigned int eax, ebx, ecx, edx;
+
+    if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) == 0 ||
+        eax < 0x80000007)
+        return 0;
+    if (__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) == 0)
+        return 0;
+
+    return (edx >> 8) & 1;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TSC_SAMPLE: Read the TSC and CLOCK_MONOTONIC (almost) at the same time:
+                the TSC value is the midpoint of two reads around the clock,
+                taking the tightest of TSC_SAMPLES tries (the others may have
+                been interrupted)
+_____________________________________________________________________________*/
+
+static void tsc_sample(uint64_t *ticks, int64_t *ns)
+{
+    uint64_t t1, t2;  // TSC values around the clock                [ticks]
+    uint64_t best;    // tightest t2 - t1 so far                    [ticks]
+    int64_t  c;       // CLOCK_MONOTONIC time                          [ns]
+    int      i;       // for-loop index
+
+    best = UINT64_MAX;
+    for (i = 0; i < TSC_SAMPLES; i++) {
+        t1 = __rdtsc();
+        c  = clock_ns();
+        t2 = __rdtsc();
+        if (t2 - t1 < best) {
+            best   = t2 - t1;
+            *ticks = t1 + (t2 - t1) / 2;
+            *ns    = c;
+        }
+    }
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TSC_TO_NS:  Convert a TSC value ticks to CLOCK_MONOTONIC nanoseconds,
+                given the conversion c (ticks before base_tsc, read on
+                another CPU, are taken as base_tsc)
+_____________________________________________________________________________*/
+
+static int64_t tsc_to_ns(const struct tsc_conv *c, uint64_t ticks)
+{
+    unsigned __int128 d;  // ticks since base_tsc, times mult
+
+    if (ticks <= c->base_tsc)
+        return c->base_ns;
+    d = (unsigned __int128)(ticks - c->base_tsc) * c->mult;
+
+    return c->base_ns + (int64_t)(d >> TSC_SHIFT);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TSC_PUBLISH:    Make c the conversion in use. Both copies are updated in
+                    turn, each while the readers use the other one, so that
+                    a reader never waits for the writer (tsc_lock must be
+                    held)
+_____________________________________________________________________________*/
+
+static void tsc_publish(const struct tsc_conv *c)
+{
+    __atomic_store_n(&tsc_seq, tsc_seq + 1, __ATOMIC_RELEASE);  // tsc[1]
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    tsc[0] = *c;
+    __atomic_store_n(&tsc_seq, tsc_seq + 1, __ATOMIC_RELEASE);  // tsc[0]
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    tsc[1] = *c;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TSC_CLAMP:  Return ns, or the highest time returned so far to the
+                calling thread if ns is lower, so that the TSC time never
+                goes backwards within a thread (e.g., when it migrates to
+                another CPU, or right after a fallback to the clock).
+                The clamp is per thread, so that reading the time never
+                writes a cache line shared with other CPUs
+_____________________________________________________________________________*/
+
+static int64_t tsc_clamp(int64_t ns)
+{
+    if (ns <= tsc_last)
+        return tsc_last;
+    tsc_last = ns;
+
+    return ns;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TSC_CHECK:  Drift check (tsc_lock must be held): compare the TSC time
+                with CLOCK_MONOTONIC, then recalibrate the rate on the
+                interval since the last check and slew it, so that the
+                drift is absorbed over the next TSC_CHECK_NS nanoseconds.
+                The conversion is rebased on the TSC time itself, hence it
+                never steps. CLOCK_MONOTONIC may be slewed by NTP (up to 500
+                ppm), hence some drift is expected; if it exceeds
+                TSC_DRIFT_PPM, the TSC is deemed unreliable and the time
+                source falls back to the clock.
+                Return 0 if the TSC is still in use, -1 otherwise
+_____________________________________________________________________________*/
+
+static int tsc_check()
+{
+    struct tsc_conv c;      // new conversion
+    uint64_t        ticks;  // current TSC value                    [ticks]
+    int64_t         ns;     // current CLOCK_MONOTONIC time            [ns]
+    int64_t         d;      // drift                                   [ns]
+    int64_t         max;    // highest drift allowed                   [ns]
+    uint64_t        rate;   // measured nanoseconds per tick, << TSC_SHIFT
+
+    if (__atomic_load_n(&time_source, __ATOMIC_RELAXED) != TIME_SOURCE_TSC)
+        return -1;
+
+    tsc_sample(&ticks, &ns);
+    if (ticks <= ref_tsc || ns <= ref_ns)
+        return 0;
+
+    c = tsc[0];
+    d = tsc_to_ns(&c, ticks) - ns;
+    __atomic_store_n(&drift, d, __ATOMIC_RELAXED);
+
+    max = (ns - ref_ns) / (1000000 / TSC_DRIFT_PPM);
+    if (d > max || d < -max) {
+        __atomic_store_n(&time_source, TIME_SOURCE_CLOCK, __ATOMIC_RELAXED);
+        return -1;
+    }
+
+    /* Absorb at most TSC_DRIFT_PPM of the drift per check */
+    max = TSC_CHECK_NS / (1000000 / TSC_DRIFT_PPM);
+    if (d > max)
+        d = max;
+    else if (d < -max)
+        d = -max;
+    rate = (uint64_t)(((unsigned __int128)(ns - ref_ns) << TSC_SHIFT) /
+                      (ticks - ref_tsc));
+
+    c.base_ns  = tsc_to_ns(&c, ticks);
+    c.base_tsc = ticks;
+    c.mult     = (uint64_t)((unsigned __int128)rate * (TSC_CHECK_NS - d) /
+                            TSC_CHECK_NS);
+    tsc_publish(&c);
+
+    ref_tsc = ticks;
+    ref_ns  = ns;
+
+    return 0;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TSC_CHECKER:    Drift checker thread: run tsc_check every TSC_CHECK_NS
+                    nanoseconds, off the time_now path, as long as the TSC
+                    is the time source in use
+_____________________________________________________________________________*/
+
+static void *tsc_checker(void *arg)
+{
+    struct timespec nap;  // check period
+    int             ret;  // tsc_check return value
+
+    (void)arg;
+    nap = ns2timespec(TSC_CHECK_NS);
+
+    do {
+        nanosleep(&nap, NULL);
+        pthread_mutex_lock(&tsc_lock);
+        ret = tsc_check();
+        if (ret != 0)
+            checker_on = 0;
+        pthread_mutex_unlock(&tsc_lock);
+    } while (ret == 0);
+
+    return NULL;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TSC_CALIBRATE:  Compute the TSC rate against CLOCK_MONOTONIC over
+                    TSC_CALIB_MS milliseconds (tsc_lock must be held).
+                    Return 0 in case of success, -1 otherwise
+_____________________________________________________________________________*/
+
+static int tsc_calibrate()
+{
+    struct timespec nap;           // calibration interval
+    struct tsc_conv c;             // new conversion
+    uint64_t        t0, t1;        // TSC values                      [ticks]
+    int64_t         ns0, ns1;      // CLOCK_MONOTONIC times              [ns]
+
+    nap = ns2timespec(TSC_CALIB_MS * NSEC_PER_MSEC);
+
+    tsc_sample(&t0, &ns0);
+    nanosleep(&nap, NULL);
+    tsc_sample(&t1, &ns1);
+
+    if (t1 <= t0 || ns1 <= ns0)
+        return -1;
+
+    c.mult     = (uint64_t)(((unsigned __int128)(ns1 - ns0) << TSC_SHIFT) /
+                            (t1 - t0));
+    c.base_tsc = t1;
+    c.base_ns  = ns1;
+    tsc_publish(&c);
+    ref_tsc = t1;
+    ref_ns  = ns1;
+    __atomic_store_n(&drift, 0, __ATOMIC_RELAXED);
+
+    return 0;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TSC_START:  Calibrate the TSC, make it the time source in use and start
+                the drift checker thread (unless already running).
+                Return 0 in case of success, -1 otherwise
+_____________________________________________________________________________*/
+
+static int tsc_start()
+{
+    pthread_attr_t attr;
+    pthread_t      tid;
+    int            ret;
+
+    pthread_mutex_lock(&tsc_lock);
+
+    ret = tsc_calibrate();
+    if (ret == 0) {
+        __atomic_store_n(&time_source, TIME_SOURCE_TSC, __ATOMIC_RELEASE);
+        if (!checker_on) {
+            pthread_attr_init(&attr);
+            pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+            if (pthread_create(&tid, &attr, tsc_checker, NULL) == 0)
+                checker_on = 1;
+            else {
+                __atomic_store_n(&time_source, TIME_SOURCE_CLOCK,
+                                 __ATOMIC_RELAXED);
+                ret = -1;
+            }
+            pthread_attr_destroy(&attr);
+        }
+    }
+
+    pthread_mutex_unlock(&tsc_lock);
+
+    return ret;
+}
+//-----------------------------------------------------------------------------
+
+#endif  // __x86_64__
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TIME_SOURCE_INIT:   Select the time source of time_now (TIME_SOURCE_*).
+                        TIME_SOURCE_TSC requires an invariant TSC (x86-64
+                        only), which is calibrated here against
+                        CLOCK_MONOTONIC, then checked for drift every
+                        TSC_CHECK_NS nanoseconds by a background thread;
+                        otherwise, the clock is used. It should be called
+                        once, before creating the tasks.
+                        Return the time source actually in use
+_____________________________________________________________________________*/
+
+int time_source_init(int source)
+{
+    assert(source == TIME_SOURCE_CLOCK || source == TIME_SOURCE_TSC);
+
+    if (virtual_now)  // see time_set_virtual
+        return TIME_SOURCE_VIRTUAL;
+
+    __atomic_store_n(&time_source, TIME_SOURCE_CLOCK, __ATOMIC_RELAXED);
+
+#if defined(__x86_64__)
+    if (source == TIME_SOURCE_TSC && tsc_invariant())
+        tsc_start();
+#endif
+
+    return __atomic_load_n(&time_source, __ATOMIC_RELAXED);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TIME_GET_SOURCE:    Return the time source in use (TIME_SOURCE_*); it
+                        switches back to TIME_SOURCE_CLOCK if a drift check
+                        fails
+_____________________________________________________________________________*/
+
+int time_get_source()
+{
+    return __atomic_load_n(&time_source, __ATOMIC_RELAXED);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TIME_SET_VIRTUAL:   Make time_now read the virtual clock now (e.g., the
+                        one of the simulation mode, see sim_init) instead of
+                        the time source in use, or switch back to the clock
+                        if now is NULL
+_____________________________________________________________________________*/
+
+void time_set_virtual(int64_t (*now)())
+{
+    virtual_now = now;
+    __atomic_store_n(&time_source,
+                     now ? TIME_SOURCE_VIRTUAL : TIME_SOURCE_CLOCK,
+                     __ATOMIC_RELEASE);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TIME_GET_DRIFT_NS:  Return the difference between the TSC and
+                        CLOCK_MONOTONIC found by the last drift check [ns]
+_____________________________________________________________________________*/
+
+int64_t time_get_drift_ns()
+{
+    return __atomic_load_n(&drift, __ATOMIC_RELAXED);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TIME_NOW_NS:    Return the current CLOCK_MONOTONIC time [ns], read from
+                    the time source in use (or the virtual time, see
+                    time_set_virtual)
+_____________________________________________________________________________*/
+
+int64_t time_now_ns()
+{
+#if defined(__x86_64__)
+    struct tsc_conv c;    // snapshot of the conversion
+    unsigned int    seq;  // latch sequence counter of the snapshot
+#endif
+    int             src;  // time source in use
+
+    src = __atomic_load_n(&time_source, __ATOMIC_ACQUIRE);
+    if (src == TIME_SOURCE_VIRTUAL)
+        return virtual_now();
+
+#if defined(__x86_64__)
+    if (src != TIME_SOURCE_TSC) {
+        if (tsc_last)  // the thread read the TSC before a fallback
+            return tsc_clamp(clock_ns());
+        return clock_ns();
+    }
+
+    do {
+        seq = __atomic_load_n(&tsc_seq, __ATOMIC_ACQUIRE);
+        c   = tsc[seq & 1];
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while (__atomic_load_n(&tsc_seq, __ATOMIC_RELAXED) != seq);
+
+    return tsc_clamp(tsc_to_ns(&c, __rdtsc()));
+#else
+    return clock_ns();
+#endif
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TIME_NOW:   Store the current CLOCK_MONOTONIC time, read from the time
+                source in use, in the time variable pointed by t
+_____________________________________________________________________________*/
+
+void time_now(struct timespec *t) { *t = ns2timespec(time_now_ns()); }
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TIME_THREAD_CPU_NS: Return the CPU time consumed by the calling thread so
+                        far (CLOCK_THREAD_CPUTIME_ID) [ns]: unlike the
+                        CLOCK_MONOTONIC time, it does not advance while the
+                        thread is preempted or blocked
+_____________________________________________________________________________*/
+
+int64_t time_thread_cpu_ns()
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t);
+
+    return timespec2ns(t);
+}
+//-----------------------------------------------------------------------------
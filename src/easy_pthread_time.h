@@ -13,9 +13,23 @@ _____________________________________________________________________________*/
 #ifndef EASY_PTHREAD_TIME_H
 #define EASY_PTHREAD_TIME_H
 
+#include <stdint.h>
 #include <time.h>
 
 
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    GLOBAL CONSTANTS
+_____________________________________________________________________________*/
+#define NSEC_PER_SEC  1000000000LL  // nanoseconds per second
+#define NSEC_PER_MSEC 1000000LL     // nanoseconds per millisecond
+#define NSEC_PER_USEC 1000LL        // nanoseconds per microsecond
+
+#define TIME_SOURCE_CLOCK   0  // clock_gettime(CLOCK_MONOTONIC)
+#define TIME_SOURCE_TSC     1  // invariant TSC, calibrated on CLOCK_MONOTONIC
+#define TIME_SOURCE_VIRTUAL 2  // virtual clock (see time_set_virtual)
+//-----------------------------------------------------------------------------
+
+
 /*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
     FUNCTION PROTOTYPES
 _____________________________________________________________________________*/
@@ -24,12 +38,34 @@ void time_copy(struct timespec *td, struct timespec ts);
 
 void time_add_ms(struct timespec *t, int ms);
 
+void time_add_ns(struct timespec *t, int64_t ns);
+
 int time_cmp(struct timespec t1, struct timespec t2);
 
 double timespec2ms(struct timespec t);
 
 double get_time_diff_in_ms(struct timespec *t1, struct timespec *t2);
 
+int64_t timespec2ns(struct timespec t);
+
+struct timespec ns2timespec(int64_t ns);
+
+int64_t get_time_diff_in_ns(struct timespec *t1, struct timespec *t2);
+
+int time_source_init(int source);
+
+int time_get_source();
+
+void time_set_virtual(int64_t (*now)());
+
+int64_t time_get_drift_ns();
+
+int64_t time_now_ns();
+
+void time_now(struct timespec *t);
+
+int64_t time_thread_cpu_ns();
+
 //-----------------------------------------------------------------------------
 
 
@@ -0,0 +1,531 @@
+//*****************************************************************************
+//******* EASY_PTHREAD_TRACE.C - For easy binary tracing of activations *******
+//*******                  Author: Livio Bisogni                   ************
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Please read the attached `README.md` file.
+_____________________________________________________________________________*/
+
+
+#include "easy_pthread_trace.h"
+#include "easy_pthread_task.h"
+#include "easy_pthread_time.h"
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    LOCAL CONSTANTS
+_____________________________________________________________________________*/
+#define RING_MASK (TRACE_RING_LEN - 1)  // record index mask
+#define NAME_LEN  (PATH_MAX + 16)       // trace file name buffer size  [byte]
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    STRUCTURES DEFINITION
+_____________________________________________________________________________*/
+
+//-----------------------------------------------------------------------------
+/* Single-producer single-consumer ring of a task */
+/* The task is the only writer of head (and dropped), the flusher the only
+   writer of tail: each one lives on its own cache line. */
+struct trace_ring
+{
+    uint64_t         head CACHE_ALIGNED;  // records written by the task
+    unsigned long    dropped;  // records lost because the ring was full
+    uint64_t         tail CACHE_ALIGNED;  // records read by the flusher
+    struct trace_rec rec[TRACE_RING_LEN] CACHE_ALIGNED;
+};
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    GLOBAL VARIABLES (definition)
+_____________________________________________________________________________*/
+/* Everything but the rings is protected by trace_lock; the rings are
+   accessed lock-free by the tasks, through the acquire/release ordering of
+   head and tail. */
+static struct trace_ring **rings;     // ring of each task index, or NULL
+static int                *attached;  // task indexes having a ring
+static int                 n_attached;  // number of attached tasks
+static char                base[PATH_MAX];  // trace file path prefix
+static uint64_t            file_cap;   // records per trace file
+static int                 files_max;  // trace files kept; 0 for all
+static int                 fd = -1;    // current trace file
+static struct trace_hdr   *map;        // mapping of the current file, or NULL
+static uint64_t            seq;        // sequence number of the current file
+static uint64_t            pos;        // records written to the current file
+static unsigned long       lost;       // records lost with no trace file
+static pthread_t           flusher;    // flusher thread
+static int                 opened;     // 1 while the trace is open
+static int                 stopping;   // 1 when the flusher must exit
+static pthread_mutex_t     trace_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t      trace_wake;  // flusher sleep (CLOCK_MONOTONIC)
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    FILE_NAME:  Write the name of the trace file with sequence number n into
+                name (NAME_LEN bytes)
+_____________________________________________________________________________*/
+
+static void file_name(char *name, uint64_t n)
+{
+    snprintf(name, NAME_LEN, "%s.%06llu", base, (unsigned long long)n);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    FILE_OPEN:  Create the trace file with the current sequence number, sized
+                for file_cap records, and map it (removing the oldest file,
+                if more than max_files would be kept).
+                Return 0 in case of success, or the error code otherwise
+_____________________________________________________________________________*/
+
+static int file_open()
+{
+    char            name[NAME_LEN];
+    size_t          size;  // size of the trace file                    [byte]
+    void           *addr;  // mapping of the trace file
+    struct timespec t;
+    int             err;
+
+    if (files_max > 0 && seq >= (uint64_t)files_max) {
+        file_name(name, seq - files_max);
+        unlink(name);
+    }
+
+    file_name(name, seq);
+    fd = open(name, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        return errno;
+
+    size = sizeof(struct trace_hdr) + file_cap * sizeof(struct trace_rec);
+    if (ftruncate(fd, size) < 0) {
+        err = errno;
+        close(fd);
+        fd = -1;
+        return err;
+    }
+    addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        err = errno;
+        close(fd);
+        fd = -1;
+        return err;
+    }
+
+    map = (struct trace_hdr *)addr;
+    memcpy(map->magic, TRACE_MAGIC, sizeof(map->magic));
+    map->version  = TRACE_VERSION;
+    map->rec_size = sizeof(struct trace_rec);
+    map->seq      = seq;
+    map->cap      = file_cap;
+    map->n_rec    = 0;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    map->mono_ns = timespec2ns(t);
+    clock_gettime(CLOCK_REALTIME, &t);
+    map->real_ns  = timespec2ns(t);
+    map->reserved = 0;
+    pos           = 0;
+
+    return 0;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    FILE_CLOSE: Finalize the current trace file (truncated to its valid
+                records) and move to the next sequence number
+_____________________________________________________________________________*/
+
+static void file_close()
+{
+    size_t size;  // size of the mapping                                [byte]
+
+    if (!map)
+        return;
+
+    map->n_rec = pos;
+    size = sizeof(struct trace_hdr) + file_cap * sizeof(struct trace_rec);
+    munmap(map, size);
+    if (pos < file_cap &&
+        ftruncate(fd, sizeof(struct trace_hdr) +
+                          pos * sizeof(struct trace_rec)) < 0)
+        perror("Error truncating the trace file");
+    close(fd);
+
+    map = NULL;
+    fd  = -1;
+    seq++;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    FLUSH_RING: Move the records of ring to the trace files, rotating them
+                when full. The records are lost if no file can be created
+_____________________________________________________________________________*/
+
+static void flush_ring(struct trace_ring *ring)
+{
+    struct trace_rec *recs;  // records of the current file
+    uint64_t          h;     // head of the ring
+    uint64_t          t;     // tail of the ring
+
+    t = ring->tail;
+    h = __atomic_load_n(&(ring->head), __ATOMIC_ACQUIRE);
+
+    while (t != h) {
+        if (map && pos == file_cap)
+            file_close();  // rotation
+        if (!map && file_open() != 0) {
+            lost += h - t;
+            t = h;
+            break;
+        }
+        recs        = (struct trace_rec *)(map + 1);
+        recs[pos++] = ring->rec[t & RING_MASK];
+        t++;
+    }
+
+    __atomic_store_n(&(ring->tail), t, __ATOMIC_RELEASE);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    FLUSH_ALL:  Flush the rings of all the attached tasks, then publish the
+                number of valid records of the current file. trace_lock
+                must be held
+_____________________________________________________________________________*/
+
+static void flush_all()
+{
+    int i;  // for-loop index
+
+    for (i = 0; i < n_attached; i++)
+        flush_ring(rings[attached[i]]);
+
+    if (map)
+        map->n_rec = pos;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TRACE_FLUSHER:  Flusher thread: every TRACE_FLUSH_MS [ms], move the
+                    buffered records to the trace files, until trace_close
+_____________________________________________________________________________*/
+
+static void *trace_flusher(void *arg)
+{
+    struct timespec next;  // next flush time
+
+    (void)arg;
+
+    pthread_mutex_lock(&trace_lock);
+
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    while (!stopping) {
+        time_add_ms(&next, TRACE_FLUSH_MS);
+        pthread_cond_timedwait(&trace_wake, &trace_lock, &next);
+        flush_all();
+    }
+
+    flush_all();
+    file_close();
+
+    pthread_mutex_unlock(&trace_lock);
+
+    return NULL;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TRACE_OPEN: Open the trace: the records of the attached tasks (see
+                trace_attach) are written by a background flusher thread
+                (SCHED_OTHER) into the files path.000000, path.000001, ...,
+                each one holding up to file_recs records; only the last
+                max_files files are kept (all of them if 0).
+                Return 0 in case of success, EBUSY if the trace is already
+                open, ENAMETOOLONG if path is too long, or the error code of
+                the first file creation or of pthread_create
+_____________________________________________________________________________*/
+
+int trace_open(const char *path, uint64_t file_recs, int max_files)
+{
+    pthread_condattr_t cattr;
+    pthread_attr_t     myatt;
+    struct sched_param mypar;
+    int                tret;
+
+    assert(path);
+    assert(file_recs > 0);
+    assert(max_files >= 0);
+
+    pthread_mutex_lock(&trace_lock);
+
+    if (opened) {
+        pthread_mutex_unlock(&trace_lock);
+        return EBUSY;
+    }
+    if (strlen(path) >= sizeof(base)) {
+        pthread_mutex_unlock(&trace_lock);
+        return ENAMETOOLONG;
+    }
+
+    strcpy(base, path);
+    file_cap   = file_recs;
+    files_max  = max_files;
+    seq        = 0;
+    lost       = 0;
+    n_attached = 0;
+    stopping   = 0;
+
+    tret = file_open();
+    if (tret != 0) {
+        pthread_mutex_unlock(&trace_lock);
+        return tret;
+    }
+
+    rings    = calloc(TASK_MAX, sizeof(*rings));
+    attached = malloc(TASK_MAX * sizeof(*attached));
+    if (!rings || !attached) {
+        perror("Error allocating the trace rings");
+        exit(EXIT_FAILURE);
+    }
+
+    pthread_condattr_init(&cattr);
+    pthread_condattr_setclock(&cattr, CLOCK_MONOTONIC);
+    pthread_cond_init(&trace_wake, &cattr);
+    pthread_condattr_destroy(&cattr);
+
+    pthread_attr_init(&myatt);
+    pthread_attr_setinheritsched(&myatt, PTHREAD_EXPLICIT_SCHED);
+    pthread_attr_setschedpolicy(&myatt, SCHED_OTHER);
+    mypar.sched_priority = 0;
+    pthread_attr_setschedparam(&myatt, &mypar);
+    tret = pthread_create(&flusher, &myatt, trace_flusher, NULL);
+    pthread_attr_destroy(&myatt);
+
+    if (tret != 0) {
+        file_close();
+        free(rings);
+        free(attached);
+        rings    = NULL;
+        attached = NULL;
+    } else
+        opened = 1;
+
+    pthread_mutex_unlock(&trace_lock);
+
+    return tret;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TRACE_ATTACH:   Allocate the ring of the j-th task (if not already
+                    done), so that its activations are traced (see
+                    trace_record). It is called at task creation, when the
+                    trace attribute is set, and must not be called on the
+                    task thread, as it allocates memory.
+                    Return 0 in case of success, or EINVAL if the trace is
+                    not open
+_____________________________________________________________________________*/
+
+int trace_attach(int j)
+{
+    struct trace_ring *ring;
+
+    assert(j < TASK_MAX);
+    assert(j >= 0);
+
+    pthread_mutex_lock(&trace_lock);
+
+    if (!opened) {
+        pthread_mutex_unlock(&trace_lock);
+        return EINVAL;
+    }
+
+    if (!rings[j]) {
+        if (posix_memalign((void **)&ring, CACHE_LINE, sizeof(*ring)) != 0) {
+            perror("posix_memalign failed!");
+            exit(EXIT_FAILURE);
+        }
+        memset(ring, 0, sizeof(*ring));  // also pre-faults the ring
+        __atomic_store_n(&(rings[j]), ring, __ATOMIC_RELEASE);
+        attached[n_attached++] = j;
+    }
+
+    pthread_mutex_unlock(&trace_lock);
+
+    return 0;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TRACE_DETACH:   Flush and free the ring of the j-th task (if any), so
+                    that its activations are no longer traced. It is called
+                    when the creation of a traced task fails, and must not
+                    be called while the task may still record activations
+_____________________________________________________________________________*/
+
+void trace_detach(int j)
+{
+    struct trace_ring *ring;  // ring of the task
+    int                i;     // for-loop index
+
+    assert(j < TASK_MAX);
+    assert(j >= 0);
+
+    pthread_mutex_lock(&trace_lock);
+
+    if (!opened || !rings[j]) {
+        pthread_mutex_unlock(&trace_lock);
+        return;
+    }
+
+    ring = rings[j];
+    flush_ring(ring);
+    if (map)
+        map->n_rec = pos;
+    __atomic_store_n(&(rings[j]), NULL, __ATOMIC_RELEASE);
+    for (i = 0; i < n_attached; i++)
+        if (attached[i] == j) {
+            attached[i] = attached[--n_attached];
+            break;
+        }
+    free(ring);
+
+    pthread_mutex_unlock(&trace_lock);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TRACE_RECORD:   Append the record of the act-th activation of the j-th
+                    task (release, start and end times in [ns], from
+                    CLOCK_MONOTONIC; dm is 1 if the deadline was missed) to
+                    its ring, without blocking nor doing any system call.
+                    Nothing is done if the task is not attached, while the
+                    record is dropped if the ring is full.
+                    Only the task itself (i.e., a single thread at a time)
+                    may record its activations
+_____________________________________________________________________________*/
+
+void trace_record(int j, uint64_t act, int64_t release, int64_t start,
+                  int64_t end, int dm)
+{
+    struct trace_ring **tab;   // ring table
+    struct trace_ring  *ring;  // ring of the task
+    struct trace_rec   *rec;   // new record
+    uint64_t            h;     // head of the ring
+
+    tab = __atomic_load_n(&rings, __ATOMIC_ACQUIRE);
+    if (!tab)
+        return;
+    ring = __atomic_load_n(&(tab[j]), __ATOMIC_ACQUIRE);
+    if (!ring)
+        return;
+
+    h = ring->head;
+    if (h - __atomic_load_n(&(ring->tail), __ATOMIC_ACQUIRE) >=
+        TRACE_RING_LEN) {
+        __atomic_store_n(&(ring->dropped), ring->dropped + 1,
+                         __ATOMIC_RELAXED);
+        return;
+    }
+
+    rec          = &(ring->rec[h & RING_MASK]);
+    rec->task    = j;
+    rec->flags   = dm ? TRACE_DM : 0;
+    rec->act     = act;
+    rec->release = release;
+    rec->start   = start;
+    rec->end     = end;
+
+    __atomic_store_n(&(ring->head), h + 1, __ATOMIC_RELEASE);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TRACE_GET_DROPPED:  Get the number of records lost so far, either
+                        because a ring was full or because no trace file
+                        could be created
+_____________________________________________________________________________*/
+
+unsigned long trace_get_dropped()
+{
+    unsigned long n;  // number of lost records
+    int           i;  // for-loop index
+
+    pthread_mutex_lock(&trace_lock);
+
+    n = lost;
+    for (i = 0; i < n_attached; i++)
+        n += __atomic_load_n(&(rings[attached[i]]->dropped), __ATOMIC_RELAXED);
+
+    pthread_mutex_unlock(&trace_lock);
+
+    return n;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TRACE_CLOSE:    Stop the flusher, after a last flush, finalize the
+                    current trace file and free the rings. The traced tasks
+                    must have ended (or stopped recording) before
+_____________________________________________________________________________*/
+
+void trace_close()
+{
+    struct trace_ring **tab;  // ring table
+    int                 i;    // for-loop index
+
+    pthread_mutex_lock(&trace_lock);
+    if (!opened) {
+        pthread_mutex_unlock(&trace_lock);
+        return;
+    }
+    stopping = 1;
+    pthread_cond_signal(&trace_wake);
+    pthread_mutex_unlock(&trace_lock);
+
+    pthread_join(flusher, NULL);
+
+    pthread_mutex_lock(&trace_lock);
+
+    tab = rings;
+    __atomic_store_n(&rings, NULL, __ATOMIC_RELEASE);
+    for (i = 0; i < n_attached; i++)
+        free(tab[attached[i]]);
+    free(tab);
+    free(attached);
+    attached   = NULL;
+    n_attached = 0;
+    pthread_cond_destroy(&trace_wake);
+    opened = 0;
+
+    pthread_mutex_unlock(&trace_lock);
+}
+//-----------------------------------------------------------------------------
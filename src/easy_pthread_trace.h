@@ -0,0 +1,92 @@
+//*****************************************************************************
+//********* EASY_PTHREAD_TRACE.H - Header file of easy_pthread_trace.c ********
+//*********                  Author: Livio Bisogni                   **********
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Please read the attached `README.md` file.
+_____________________________________________________________________________*/
+
+
+#ifndef EASY_PTHREAD_TRACE_H
+#define EASY_PTHREAD_TRACE_H
+
+#include <stdint.h>
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    GLOBAL CONSTANTS
+_____________________________________________________________________________*/
+#define TRACE_MAGIC    "EPTTRACE"  // first 8 bytes of every trace file
+#define TRACE_VERSION  1           // version of the trace file format
+#define TRACE_RING_LEN 1024  // records buffered per task (a power of 2)
+#define TRACE_FLUSH_MS 20    // period of the flusher thread              [ms]
+
+#define TRACE_DM 0x1  // record flag: the deadline was missed
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    STRUCTURES DEFINITION
+_____________________________________________________________________________*/
+
+//-----------------------------------------------------------------------------
+/* Trace record */
+/* One per activation; all the times are read from CLOCK_MONOTONIC. */
+struct trace_rec
+{
+    uint32_t task;     // task index
+    uint32_t flags;    // TRACE_* flags
+    uint64_t act;      // activation index (0 for the first one)
+    int64_t  release;  // nominal release time                              [ns]
+    int64_t  start;    // start time                                        [ns]
+    int64_t  end;      // completion time                                   [ns]
+};
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+/* Trace file header */
+/* Each trace file starts with this header, followed by cap records, of which
+   only the first n_rec are valid. n_rec is updated by the flusher after each
+   flush, so that a file is readable even if the process did not end
+   properly. mono_ns and real_ns are read at the same time, to convert the
+   record times into wall-clock times. */
+struct trace_hdr
+{
+    char     magic[8];  // TRACE_MAGIC (not null-terminated)
+    uint32_t version;   // TRACE_VERSION
+    uint32_t rec_size;  // size of a record                               [byte]
+    uint64_t seq;       // sequence number of the file (0 for the first one)
+    uint64_t cap;       // number of records the file can hold
+    uint64_t n_rec;     // number of valid records
+    int64_t  mono_ns;   // CLOCK_MONOTONIC time of the file creation      [ns]
+    int64_t  real_ns;   // CLOCK_REALTIME time of the file creation       [ns]
+    uint64_t reserved;  // 0 (pads the header to 64 bytes)
+};
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    FUNCTION PROTOTYPES
+_____________________________________________________________________________*/
+
+int trace_open(const char *path, uint64_t file_recs, int max_files);
+
+int trace_attach(int j);
+
+void trace_detach(int j);
+
+void trace_record(int j, uint64_t act, int64_t release, int64_t start,
+                  int64_t end, int dm);
+
+unsigned long trace_get_dropped();
+
+void trace_close();
+
+//-----------------------------------------------------------------------------
+
+
+#endif  // EASY_PTHREAD_TRACE_H
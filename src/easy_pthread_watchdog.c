@@ -0,0 +1,213 @@
+//*****************************************************************************
+//************ EASY_PTHREAD_WATCHDOG.C - Deadline watchdog timers *************
+//************              Author: Livio Bisogni                  ************
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Please read the attached `README.md` file.
+_____________________________________________________________________________*/
+
+
+#include "easy_pthread_watchdog.h"
+#include "easy_pthread_time.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    LOCAL CONSTANTS
+_____________________________________________________________________________*/
+#define WDOG_EVENTS 16  // expired timers handled per epoll_wait
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    GLOBAL VARIABLES (definition)
+_____________________________________________________________________________*/
+
+static pthread_mutex_t wdog_lock = PTHREAD_MUTEX_INITIALIZER;
+static int             epfd      = -1;    // epoll set of the timers
+static pthread_t       wdog_tid;          // watchdog thread
+static void          (*wdog_fire)(int);   // called when a timer expires
+static int            *fd_task;  // task of each timer fd, or -1
+static int             fd_cap;   // number of entries of fd_task
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    WDOG_THREAD:    Body of the watchdog thread: sleep in epoll_wait until
+                    some timers expire, then call the fire function for
+                    each of their tasks. A timer removed (and its fd
+                    possibly reused) after epoll_wait returned is skipped,
+                    as well as a timer re-armed meanwhile (nothing to read)
+_____________________________________________________________________________*/
+
+static void *wdog_thread(void *arg)
+{
+    struct epoll_event ev[WDOG_EVENTS];
+    uint64_t           exp;  // number of expirations
+    int                fd;   // timer fd
+    int                j;    // task index
+    int                n;    // number of expired timers
+    int                i;    // for-loop index
+
+    (void)arg;
+
+    for (;;) {
+        n = epoll_wait(epfd, ev, WDOG_EVENTS, -1);
+
+        pthread_mutex_lock(&wdog_lock);
+        for (i = 0; i < n; i++) {
+            fd = (int)(ev[i].data.u64 >> 32);
+            j  = (int)(uint32_t)ev[i].data.u64;
+            if (fd >= fd_cap || fd_task[fd] != j)
+                continue;
+            if (read(fd, &exp, sizeof(exp)) == sizeof(exp))
+                wdog_fire(j);
+        }
+        pthread_mutex_unlock(&wdog_lock);
+    }
+
+    return NULL;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    WDOG_START: Create the epoll set and the watchdog thread, under
+                SCHED_FIFO at the highest priority (so that it preempts the
+                late task), or with the default policy if it is not allowed.
+                The caller must hold wdog_lock.
+                Return 0 in case of success, -1 otherwise
+_____________________________________________________________________________*/
+
+static int wdog_start()
+{
+    pthread_attr_t     myatt;
+    struct sched_param mypar;
+    int                tret;
+
+    epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (epfd < 0)
+        return -1;
+
+    pthread_attr_init(&myatt);
+    pthread_attr_setinheritsched(&myatt, PTHREAD_EXPLICIT_SCHED);
+    pthread_attr_setschedpolicy(&myatt, SCHED_FIFO);
+    mypar.sched_priority = sched_get_priority_max(SCHED_FIFO);
+    pthread_attr_setschedparam(&myatt, &mypar);
+    tret = pthread_create(&wdog_tid, &myatt, wdog_thread, NULL);
+    pthread_attr_destroy(&myatt);
+
+    if (tret != 0)  // e.g., EPERM
+        tret = pthread_create(&wdog_tid, NULL, wdog_thread, NULL);
+    if (tret != 0) {
+        close(epfd);
+        epfd = -1;
+        return -1;
+    }
+    pthread_detach(wdog_tid);
+
+    return 0;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    WDOG_ADD:   Create a (disarmed) timer for the j-th task, calling fire(j)
+                from the watchdog thread when it expires; fire must be the
+                same for every timer. The watchdog thread is started by the
+                first call.
+                Return the timer fd, or -1 in case of error
+_____________________________________________________________________________*/
+
+int wdog_add(int j, void (*fire)(int j))
+{
+    struct epoll_event ev;
+    int               *tab;  // resized fd_task
+    int                fd;   // timer fd
+    int                i;    // for-loop index
+
+    pthread_mutex_lock(&wdog_lock);
+
+    if (epfd < 0 && wdog_start() < 0) {
+        pthread_mutex_unlock(&wdog_lock);
+        return -1;
+    }
+    wdog_fire = fire;
+
+    fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (fd < 0) {
+        pthread_mutex_unlock(&wdog_lock);
+        return -1;
+    }
+
+    if (fd >= fd_cap) {
+        tab = realloc(fd_task, (fd + 1) * 2 * sizeof(*tab));
+        if (!tab) {
+            close(fd);
+            pthread_mutex_unlock(&wdog_lock);
+            return -1;
+        }
+        for (i = fd_cap; i < (fd + 1) * 2; i++)
+            tab[i] = -1;
+        fd_task = tab;
+        fd_cap  = (fd + 1) * 2;
+    }
+
+    ev.events   = EPOLLIN;
+    ev.data.u64 = ((uint64_t)fd << 32) | (uint32_t)j;
+    if (epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        close(fd);
+        pthread_mutex_unlock(&wdog_lock);
+        return -1;
+    }
+    fd_task[fd] = j;
+
+    pthread_mutex_unlock(&wdog_lock);
+
+    return fd;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    WDOG_ARM:   Arm the timer fd to expire at the CLOCK_MONOTONIC time at_ns
+                [ns] (at once, if already past), replacing any previous
+                expiration time. It costs a single system call
+_____________________________________________________________________________*/
+
+void wdog_arm(int fd, int64_t at_ns)
+{
+    struct itimerspec its;
+
+    its.it_interval.tv_sec  = 0;
+    its.it_interval.tv_nsec = 0;
+    its.it_value            = ns2timespec(at_ns);
+    timerfd_settime(fd, TFD_TIMER_ABSTIME, &its, NULL);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    WDOG_REMOVE:    Remove and close the timer fd. Once it returns, the fire
+                    function is not called for it anymore
+_____________________________________________________________________________*/
+
+void wdog_remove(int fd)
+{
+    pthread_mutex_lock(&wdog_lock);
+
+    epoll_ctl(epfd, EPOLL_CTL_DEL, fd, NULL);
+    fd_task[fd] = -1;
+    close(fd);
+
+    pthread_mutex_unlock(&wdog_lock);
+}
+//-----------------------------------------------------------------------------
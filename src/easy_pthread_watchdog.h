@@ -0,0 +1,32 @@
+//*****************************************************************************
+//****** EASY_PTHREAD_WATCHDOG.H - Header file of easy_pthread_watchdog.c *****
+//******                    Author: Livio Bisogni                     *********
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Please read the attached `README.md` file.
+_____________________________________________________________________________*/
+
+
+#ifndef EASY_PTHREAD_WATCHDOG_H
+#define EASY_PTHREAD_WATCHDOG_H
+
+#include <stdint.h>
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    FUNCTION PROTOTYPES
+_____________________________________________________________________________*/
+
+int wdog_add(int j, void (*fire)(int j));
+
+void wdog_arm(int fd, int64_t at_ns);
+
+void wdog_remove(int fd);
+
+//-----------------------------------------------------------------------------
+
+
+#endif  // EASY_PTHREAD_WATCHDOG_H
@@ -0,0 +1,276 @@
+//*****************************************************************************
+//************ EASY_PTHREAD_WINDOW.C - Sliding-window statistics **************
+//************              Author: Livio Bisogni                  ************
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Please read the attached `README.md` file.
+_____________________________________________________________________________*/
+
+
+#include "easy_pthread_window.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    ZALLOC: Allocate n bytes and clear them (touching all of the memory, so
+            that no page fault is taken when the window is updated)
+_____________________________________________________________________________*/
+
+static void *zalloc(size_t n)
+{
+    void *p;
+
+    p = malloc(n);
+    if (p)
+        memset(p, 0, n);
+
+    return p;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    RT_WINDOW_INIT: Initialize the window pointed by w, holding at most cap
+                    samples, none older than span_ns nanoseconds (if
+                    positive) than the newest one.
+                    Return 0 in case of success, -1 otherwise
+_____________________________________________________________________________*/
+
+int rt_window_init(struct rt_window *w, unsigned long cap, int64_t span_ns)
+{
+    memset(w, 0, sizeof(*w));
+    if (cap == 0)
+        return -1;
+
+    w->cap     = cap;
+    w->span_ns = span_ns > 0 ? span_ns : 0;
+    w->val     = zalloc(cap * sizeof(*(w->val)));
+    w->dm      = zalloc(cap * sizeof(*(w->dm)));
+    w->dq_min  = zalloc(cap * sizeof(*(w->dq_min)));
+    w->dq_max  = zalloc(cap * sizeof(*(w->dq_max)));
+    if (w->span_ns)
+        w->t = zalloc(cap * sizeof(*(w->t)));
+
+    if (!w->val || !w->dm || !w->dq_min || !w->dq_max ||
+        (w->span_ns && !w->t)) {
+        rt_window_free(w);
+        return -1;
+    }
+
+    return 0;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    RT_WINDOW_FREE: Free the window pointed by w (if any)
+_____________________________________________________________________________*/
+
+void rt_window_free(struct rt_window *w)
+{
+    free(w->val);
+    free(w->t);
+    free(w->dm);
+    free(w->dq_min);
+    free(w->dq_max);
+    memset(w, 0, sizeof(*w));
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    RECOMPUTE:  Recompute the mean and the sum of squared deviations of the
+                window pointed by w from its samples (two passes), dropping
+                the rounding error that undoing the running update builds
+_____________________________________________________________________________*/
+
+static void recompute(struct rt_window *w)
+{
+    unsigned long s;      // sequence number of a sample
+    double        sum;    // sum of the samples
+    double        delta;  // distance of a sample from the mean
+
+    sum = 0;
+    for (s = w->first; s < w->next; s++)
+        sum += w->val[s % w->cap];
+    w->mean = w->first < w->next ? sum / (w->next - w->first) : 0;
+
+    w->m2 = 0;
+    for (s = w->first; s < w->next; s++) {
+        delta = w->val[s % w->cap] - w->mean;
+        w->m2 += delta * delta;
+    }
+
+    w->n_evict = 0;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    EVICT:  Remove the oldest sample from the window pointed by w
+_____________________________________________________________________________*/
+
+static void evict(struct rt_window *w)
+{
+    unsigned long s;      // sequence number of the oldest sample
+    double        y;      // oldest sample
+    double        delta;  // distance of y from the mean
+
+    s = w->first++;
+    y = w->val[s % w->cap];
+
+    if (w->min_head < w->min_tail && w->dq_min[w->min_head % w->cap] == s)
+        w->min_head++;
+    if (w->max_head < w->max_tail && w->dq_max[w->max_head % w->cap] == s)
+        w->max_head++;
+
+    w->n_dm -= w->dm[s % w->cap];
+
+    if (w->first == w->next) {
+        w->mean = 0;
+        w->m2   = 0;
+        return;
+    }
+    delta = y - w->mean;
+    w->mean -= delta / (w->next - w->first);
+    w->m2 -= delta * (y - w->mean);
+    if (w->m2 < 0)  // rounding
+        w->m2 = 0;
+
+    /* Every cap evictions, i.e., at most once per window length, so that
+       the amortized cost stays constant */
+    if (++w->n_evict >= w->cap)
+        recompute(w);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    RT_WINDOW_ADD:  Add the sample x, recorded at time t [ns] (only used by
+                    time windows) with dm deadline misses, to the window
+                    pointed by w, after removing the samples that leave it
+                    (the oldest one, if full, and the ones not newer than
+                    t - span_ns)
+_____________________________________________________________________________*/
+
+void rt_window_add(struct rt_window *w, double x, int64_t t, unsigned dm)
+{
+    unsigned long s;      // sequence number of x
+    double        delta;  // distance of x from the mean
+
+    if (w->next - w->first == w->cap)
+        evict(w);
+    if (w->span_ns)
+        while (w->first < w->next &&
+               t - w->t[w->first % w->cap] >= w->span_ns)
+            evict(w);
+
+    /* Drop the candidates that x makes useless, then append x */
+    while (w->min_head < w->min_tail &&
+           w->val[w->dq_min[(w->min_tail - 1) % w->cap] % w->cap] >= x)
+        w->min_tail--;
+    while (w->max_head < w->max_tail &&
+           w->val[w->dq_max[(w->max_tail - 1) % w->cap] % w->cap] <= x)
+        w->max_tail--;
+
+    s = w->next++;
+    w->val[s % w->cap] = x;
+    w->dm[s % w->cap]  = dm;
+    if (w->span_ns)
+        w->t[s % w->cap] = t;
+    w->dq_min[w->min_tail++ % w->cap] = s;
+    w->dq_max[w->max_tail++ % w->cap] = s;
+    w->n_dm += dm;
+
+    delta = x - w->mean;
+    w->mean += delta / (w->next - w->first);
+    w->m2 += delta * (x - w->mean);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    RT_WINDOW_COUNT:    Return the number of samples in the window pointed by
+                        w
+_____________________________________________________________________________*/
+
+unsigned long rt_window_count(const struct rt_window *w)
+{
+    return w->next - w->first;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    RT_WINDOW_MIN:  Return the minimum sample in the window pointed by w (0
+                    if empty), in O(1)
+_____________________________________________________________________________*/
+
+double rt_window_min(const struct rt_window *w)
+{
+    if (w->min_head >= w->min_tail)
+        return 0;
+
+    return w->val[w->dq_min[w->min_head % w->cap] % w->cap];
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    RT_WINDOW_MAX:  Return the maximum sample in the window pointed by w (0
+                    if empty), in O(1)
+_____________________________________________________________________________*/
+
+double rt_window_max(const struct rt_window *w)
+{
+    if (w->max_head >= w->max_tail)
+        return 0;
+
+    return w->val[w->dq_max[w->max_head % w->cap] % w->cap];
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    RT_WINDOW_AVG:  Return the mean of the samples in the window pointed by w
+                    (0 if empty)
+_____________________________________________________________________________*/
+
+double rt_window_avg(const struct rt_window *w)
+{
+    return w->mean;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    RT_WINDOW_STD:  Return the (corrected sample) standard deviation of the
+                    samples in the window pointed by w (0 if less than two)
+_____________________________________________________________________________*/
+
+double rt_window_std(const struct rt_window *w)
+{
+    unsigned long n;  // number of samples
+
+    n = w->next - w->first;
+
+    return n > 1 ? sqrt(w->m2 / (n - 1)) : 0;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    RT_WINDOW_DM:   Return the number of deadline misses of the samples in the
+                    window pointed by w
+_____________________________________________________________________________*/
+
+unsigned long rt_window_dm(const struct rt_window *w)
+{
+    return w->n_dm;
+}
+//-----------------------------------------------------------------------------
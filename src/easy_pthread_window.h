@@ -0,0 +1,80 @@
+//*****************************************************************************
+//******** EASY_PTHREAD_WINDOW.H - Header file of easy_pthread_window.c *******
+//********                  Author: Livio Bisogni                     *********
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Please read the attached `README.md` file.
+_____________________________________________________________________________*/
+
+
+#ifndef EASY_PTHREAD_WINDOW_H
+#define EASY_PTHREAD_WINDOW_H
+
+#include <stdint.h>
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    STRUCTURES DEFINITION
+_____________________________________________________________________________*/
+
+//-----------------------------------------------------------------------------
+/* Sliding window */
+/* Statistics of the last (at most) cap samples, possibly also limited to the
+   ones recorded in the last span_ns nanoseconds. Samples are numbered by a
+   sequence number s, and held at position s % cap. The minimum and the
+   maximum are kept by two monotonic deques of sequence numbers (the front
+   of each one being the current extreme), the mean and the variance by a
+   running (Welford) update, undone when a sample leaves the window: each
+   sample is thus pushed and popped at most once (amortized O(1)). */
+struct rt_window
+{
+    unsigned long  cap;       // capacity; 0 if the window is not used
+    int64_t        span_ns;   // time span; 0 for a count window only  [ns]
+    double        *val;       // samples
+    int64_t       *t;         // times of the samples (time windows)   [ns]
+    unsigned      *dm;        // deadline misses of each sample
+    unsigned long *dq_min;    // deque of the minimum (increasing values)
+    unsigned long *dq_max;    // deque of the maximum (decreasing values)
+    unsigned long  min_head;  // front of dq_min (sequence numbers are
+    unsigned long  min_tail;  // back of dq_min   at dq_*[head..tail - 1],
+    unsigned long  max_head;  // front of dq_max  modulo cap)
+    unsigned long  max_tail;  // back of dq_max
+    unsigned long  first;     // sequence number of the oldest sample
+    unsigned long  next;      // sequence number of the next sample
+    unsigned long  n_dm;      // deadline misses in the window
+    double         mean;      // running mean
+    double         m2;        // running sum of squared deviations
+    unsigned long  n_evict;   // evictions since mean and m2 were recomputed
+};
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    FUNCTION PROTOTYPES
+_____________________________________________________________________________*/
+
+int rt_window_init(struct rt_window *w, unsigned long cap, int64_t span_ns);
+
+void rt_window_free(struct rt_window *w);
+
+void rt_window_add(struct rt_window *w, double x, int64_t t, unsigned dm);
+
+unsigned long rt_window_count(const struct rt_window *w);
+
+double rt_window_min(const struct rt_window *w);
+
+double rt_window_max(const struct rt_window *w);
+
+double rt_window_avg(const struct rt_window *w);
+
+double rt_window_std(const struct rt_window *w);
+
+unsigned long rt_window_dm(const struct rt_window *w);
+
+//-----------------------------------------------------------------------------
+
+
+#endif  // EASY_PTHREAD_WINDOW_H
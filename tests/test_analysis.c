@@ -0,0 +1,111 @@
+//*****************************************************************************
+//************ TEST_ANALYSIS.C - Schedulability analysis unit test ************
+//************              Author: Livio Bisogni                ************
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Check the utilization bounds and the response time analysis against
+    textbook task sets, whose worst-case response times are computed by
+    hand, and the fallback of the bounds to the response time analysis
+    when their assumptions do not hold.
+_____________________________________________________________________________*/
+
+
+#include "easy_pthread_analysis.h"
+#include "test_check.h"
+#include <math.h>
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    LOCAL CONSTANTS
+_____________________________________________________________________________*/
+#define MS 1000000  // one millisecond                                    [ns]
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    SET_TASK:   Fill the task pointed by t with period per, deadline dl and
+                WCET wcet (all in [ms]), and priority pri
+_____________________________________________________________________________*/
+
+static void set_task(struct analysis_task *t, int per, int dl, int wcet,
+                     int pri)
+{
+    t->per  = (int64_t)per * MS;
+    t->dl   = (int64_t)dl * MS;
+    t->wcet = (int64_t)wcet * MS;
+    t->pri  = pri;
+    t->wcrt = 0;
+}
+//-----------------------------------------------------------------------------
+
+
+int main()
+{
+    struct analysis_task ts[3];
+
+    // Bounds
+    CHECK(analysis_ll_bound(1) == 1);
+    CHECK(fabs(analysis_ll_bound(2) - 0.828427) < 1e-6);
+    CHECK(fabs(analysis_ll_bound(3) - 0.779763) < 1e-6);
+
+    // U = 0.55: every test passes
+    set_task(&ts[0], 4, 4, 1, 30);
+    set_task(&ts[1], 5, 5, 1, 20);
+    set_task(&ts[2], 10, 10, 1, 10);
+    CHECK(analysis_is_rm(ts, 3));
+    CHECK(analysis_run(ts, 3, ANALYSIS_LL));
+    CHECK(analysis_run(ts, 3, ANALYSIS_HYPERBOLIC));
+    CHECK(analysis_run(ts, 3, ANALYSIS_RTA));
+    CHECK(ts[0].wcrt == 1 * MS);
+    CHECK(ts[1].wcrt == 2 * MS);
+    CHECK(ts[2].wcrt == 3 * MS);
+
+    // U = 0.883: above both bounds, but schedulable (R3 = 10 = D3)
+    set_task(&ts[0], 4, 4, 1, 30);
+    set_task(&ts[1], 6, 6, 2, 20);
+    set_task(&ts[2], 10, 10, 3, 10);
+    CHECK(fabs(analysis_util(ts, 3) - (0.25 + 2.0 / 6 + 0.3)) < 1e-12);
+    CHECK(!analysis_test_ll(ts, 3));
+    CHECK(!analysis_test_hyperbolic(ts, 3));
+    CHECK(analysis_rta(ts, 3));
+    CHECK(ts[0].wcrt == 1 * MS);
+    CHECK(ts[1].wcrt == 3 * MS);
+    CHECK(ts[2].wcrt == 10 * MS);
+    CHECK(analysis_run(ts, 3, ANALYSIS_NONE));
+
+    // C3 = 4: the lowest priority task misses its deadline (R3 > 10)
+    set_task(&ts[2], 10, 10, 4, 10);
+    CHECK(!analysis_run(ts, 3, ANALYSIS_RTA));
+    CHECK(ts[0].wcrt == 1 * MS);
+    CHECK(ts[1].wcrt == 3 * MS);
+    CHECK(ts[2].wcrt > 10 * MS);
+
+    // Inverted priorities, U = 0.8 < LL(2): the bound must not be trusted
+    set_task(&ts[0], 10, 10, 5, 10);
+    set_task(&ts[1], 20, 20, 6, 20);
+    CHECK(analysis_test_ll(ts, 2));
+    CHECK(!analysis_is_rm(ts, 2));
+    CHECK(!analysis_run(ts, 2, ANALYSIS_LL));
+    CHECK(!analysis_run(ts, 2, ANALYSIS_HYPERBOLIC));
+    CHECK(ts[1].wcrt == 6 * MS);
+
+    // Constrained deadline, U = 0.5: R2 = 3 > D2 = 2
+    set_task(&ts[0], 4, 4, 1, 20);
+    set_task(&ts[1], 8, 2, 2, 10);
+    CHECK(!analysis_is_rm(ts, 2));
+    CHECK(!analysis_run(ts, 2, ANALYSIS_LL));
+    CHECK(ts[1].wcrt > 2 * MS);
+
+    // Equal priorities interfere with each other
+    set_task(&ts[0], 10, 10, 2, 10);
+    set_task(&ts[1], 10, 10, 3, 10);
+    CHECK(analysis_rta(ts, 2));
+    CHECK(ts[0].wcrt == 5 * MS);
+    CHECK(ts[1].wcrt == 5 * MS);
+
+    return TEST_RESULT();
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,48 @@
+//*****************************************************************************
+//************** TEST_CHECK.H - Minimal checks for the unit tests *************
+//**************              Author: Livio Bisogni             **************
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Each test program includes this header, checks its conditions with
+    CHECK (a failed one is reported, and the test goes on), and returns
+    TEST_RESULT() from main, so that ctest reports it as failed if any
+    check failed (or TEST_SKIP, if it cannot run, e.g., without real-time
+    privileges).
+_____________________________________________________________________________*/
+
+
+#ifndef TEST_CHECK_H
+#define TEST_CHECK_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    GLOBAL CONSTANTS
+_____________________________________________________________________________*/
+#define CHECK(cond)                                                  \
+    do {                                                             \
+        if (!(cond)) {                                               \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__,   \
+                    __LINE__, #cond);                                \
+            test_failures++;                                         \
+        }                                                            \
+    } while (0)
+
+#define TEST_RESULT() (test_failures ? EXIT_FAILURE : EXIT_SUCCESS)
+#define TEST_SKIP     77  // returned when the test cannot run here
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    GLOBAL VARIABLES (definition)
+_____________________________________________________________________________*/
+static int test_failures;  // number of failed checks
+//-----------------------------------------------------------------------------
+
+
+#endif  // TEST_CHECK_H
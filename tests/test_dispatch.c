@@ -0,0 +1,134 @@
+//*****************************************************************************
+//************* TEST_DISPATCH.C - Timing-wheel dispatcher unit test ***********
+//*************              Author: Livio Bisogni              ***************
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Run the dispatcher for RUN_MS milliseconds with:
+        * two jobs whose periods exceed the span of the first wheel level,
+          so that each of their releases is cascaded down from the second
+          one: they must be released the expected number of times, close
+          to their nominal release times
+        * a job longer than its period: each release found pending must be
+          skipped, and counted as a deadline miss, like each late run
+    The dispatcher threads run under SCHED_RR: the test is skipped if this
+    is not allowed.
+_____________________________________________________________________________*/
+
+
+#include "easy_pthread_dispatch.h"
+#include "test_check.h"
+#include <errno.h>
+#include <time.h>
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    LOCAL CONSTANTS
+_____________________________________________________________________________*/
+#define MS       1000000  // one millisecond                              [ns]
+#define TICK     100000   // dispatcher tick (first level span: 25.6 ms)  [ns]
+#define PRIO     10       // priority of the dispatcher threads
+#define RUN_MS   1000     // test duration                                [ms]
+#define SLOW_PER 10       // period of the job longer than it            [ms]
+#define SLOW_EXE 25       // execution time of that job                   [ms]
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    SLEEP_MS:   Sleep for ms milliseconds
+_____________________________________________________________________________*/
+
+static void sleep_ms(int ms)
+{
+    struct timespec t;
+
+    t.tv_sec  = ms / 1000;
+    t.tv_nsec = (long)(ms % 1000) * MS;
+    nanosleep(&t, NULL);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    COUNT_JOB:  Count the activations in the counter pointed by arg
+_____________________________________________________________________________*/
+
+static void count_job(int j, void *arg)
+{
+    (void)j;
+
+    __atomic_fetch_add((int *)arg, 1, __ATOMIC_RELAXED);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    SLOW_JOB:   Count the activation, then run for SLOW_EXE milliseconds
+_____________________________________________________________________________*/
+
+static void slow_job(int j, void *arg)
+{
+    count_job(j, arg);
+    sleep_ms(SLOW_EXE);
+}
+//-----------------------------------------------------------------------------
+
+
+int main()
+{
+    int           per[2] = {40, 100};  // periods of the cascaded jobs  [ms]
+    int           n[3]   = {0, 0, 0};  // activations of each job
+    int           j[3];                // job indexes
+    unsigned long ovr;                 // releases skipped by the slow job
+    int           ret;
+    int           i;                   // for-loop index
+
+    ret = dispatch_start(1, PRIO, TICK);
+    if (ret == EPERM) {
+        fprintf(stderr, "SCHED_RR not allowed: test skipped\n");
+        return TEST_SKIP;
+    }
+    CHECK(ret == 0);
+    if (ret != 0)
+        return TEST_RESULT();
+
+    for (i = 0; i < 2; i++) {
+        j[i] = task_alloc();
+        CHECK(dispatch_add(j[i], count_job, &n[i], (int64_t)per[i] * MS,
+                           (int64_t)per[i] * MS, PRIO + 1, NULL) == 0);
+    }
+    j[2] = task_alloc();
+    CHECK(dispatch_add(j[2], slow_job, &n[2], SLOW_PER * MS, SLOW_PER * MS,
+                       PRIO, NULL) == 0);
+    CHECK(dispatch_add(j[2], slow_job, &n[2], SLOW_PER * MS, SLOW_PER * MS,
+                       PRIO, NULL) == EBUSY);
+
+    sleep_ms(RUN_MS);
+
+    // The jobs are removed by dispatch_stop, but their statistics are kept
+    ovr = dispatch_get_overruns(j[2]);
+    dispatch_stop();
+
+    for (i = 0; i < 2; i++) {
+        CHECK(n[i] >= RUN_MS / per[i] - 1);
+        CHECK(n[i] <= RUN_MS / per[i] + 1);
+        CHECK(task_get_deadline_miss(j[i]) == 0);
+        CHECK(task_get_rt_max(j[i]) < per[i]);
+    }
+
+    CHECK(n[2] > 0);
+    CHECK(ovr > 0);
+    CHECK(task_get_deadline_miss(j[2]) >= (int)ovr + n[2]);  // all late
+    CHECK(task_get_deadline_miss(j[2]) <= (int)ovr + n[2] + 1);
+    CHECK(n[2] + (int)ovr >= RUN_MS / SLOW_PER - 2);
+
+    // A job added once stopped is not left behind as a live task
+    CHECK(dispatch_add(task_alloc(), count_job, &n[0], MS, MS, PRIO, NULL) ==
+          EINVAL);
+    CHECK(task_get_count() == 0);
+
+    return TEST_RESULT();
+}
+//-----------------------------------------------------------------------------
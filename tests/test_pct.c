@@ -0,0 +1,146 @@
+//*****************************************************************************
+//*************** TEST_PCT.C - Percentile computation unit test ***************
+//***************            Author: Livio Bisogni             ***************
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Check the exact percentiles (quickselect) and the histogram ones against
+    the sorted values, on pseudo-random samples with a long tail and on
+    repeated values: the former must match exactly, the latter within the
+    relative error of the histogram buckets.
+_____________________________________________________________________________*/
+
+
+#include "easy_pthread_pct.h"
+#include "test_check.h"
+#include <math.h>
+#include <string.h>
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    LOCAL CONSTANTS
+_____________________________________________________________________________*/
+#define N_VAL 20011  // number of samples (prime, so no percentile is exact)
+#define N_Q   7      // number of percentiles
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    GLOBAL VARIABLES (definition)
+_____________________________________________________________________________*/
+static double v[N_VAL];       // samples
+static double sorted[N_VAL];  // samples, sorted
+static double work[N_VAL];    // samples, reordered by pct_select
+static const double q[N_Q] = {99, 0, 50, 99.9, 100, 90, 50};  // percentiles
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    NEXT_RAND:  Return the next value of a linear congruential generator (the
+                same on every platform, unlike rand)
+_____________________________________________________________________________*/
+
+static uint32_t next_rand()
+{
+    static uint32_t x = 12345;
+
+    x = x * 1103515245u + 12345u;
+
+    return x >> 8;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    CMP_DOUBLE: Comparison function of qsort
+_____________________________________________________________________________*/
+
+static int cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+
+    return (x > y) - (x < y);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    CHECK_PERCENTILES:  Check the percentiles of the first n samples of v,
+                        computed by pct_select and by the histogram, against
+                        the sorted samples
+_____________________________________________________________________________*/
+
+static void check_percentiles(unsigned long n)
+{
+    struct pct_hist h;
+    double          out[N_Q];  // exact percentiles
+    double          ref;       // percentile of the sorted samples
+    double          err;       // highest error of the histogram
+    unsigned long   k;         // rank
+    unsigned long   i;         // for-loop index
+
+    memcpy(sorted, v, n * sizeof(*v));
+    qsort(sorted, n, sizeof(*sorted), cmp_double);
+
+    memcpy(work, v, n * sizeof(*v));
+    CHECK(pct_select(work, n, q, out, N_Q) == 0);
+
+    CHECK(pct_hist_init(&h) == 0);
+    for (i = 0; i < n; i++)
+        pct_hist_add(&h, (int64_t)v[i]);
+    CHECK(h.n == n);
+
+    for (i = 0; i < N_Q; i++) {
+        k   = pct_rank(q[i], n);
+        ref = sorted[k - 1];
+        CHECK(out[i] == ref);
+        err = ref / (1 << (PCT_SUB_BITS + 1)) + 0.5;
+        CHECK(fabs(pct_hist_value(&h, k) - ref) <= err);
+    }
+
+    pct_hist_free(&h);
+}
+//-----------------------------------------------------------------------------
+
+
+int main()
+{
+    double        out;  // percentile
+    unsigned long i;    // for-loop index
+
+    // Nearest ranks
+    CHECK(pct_rank(0, 10) == 1);
+    CHECK(pct_rank(50, 10) == 5);
+    CHECK(pct_rank(50, 11) == 6);
+    CHECK(pct_rank(99, 10) == 10);
+    CHECK(pct_rank(100, 10) == 10);
+    CHECK(pct_rank(100, 1) == 1);
+
+    // Response times around 1 ms, with a long tail up to about 1 s
+    for (i = 0; i < N_VAL; i++) {
+        v[i] = 900000 + next_rand() % 200000;
+        if (i % 97 == 0)
+            v[i] *= 1 + next_rand() % 1000;
+    }
+    check_percentiles(N_VAL);
+
+    // Small values, counted one per bucket: the histogram is exact
+    for (i = 0; i < N_VAL; i++)
+        v[i] = next_rand() % 200;
+    check_percentiles(N_VAL);
+
+    // Repeated values, and a single one
+    for (i = 0; i < N_VAL; i++)
+        v[i] = 1000 + i % 3;
+    check_percentiles(N_VAL);
+    check_percentiles(1);
+
+    // No values
+    CHECK(pct_select(work, 0, &out, &out, 1) == -1);
+
+    return TEST_RESULT();
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,207 @@
+//*****************************************************************************
+//*************** TEST_SIM.C - Virtual-time simulation unit test **************
+//***************              Author: Livio Bisogni             **************
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Simulate the task set (10, 3), (20, 5), (40, 12) ms (period, declared
+    execution time; the deadlines equal the periods, and the priorities
+    are rate monotonic) up to HORIZON_MS, under fixed priorities and under
+    EDF, and check the start time of each job, and the response times and
+    deadline misses of each task, against the schedules computed by hand
+    (on ties, EDF runs the job released first). The response times are
+    measured from the start of the jobs, as task_run_periodic does.
+    Since the simulation mode cannot be left, each policy is simulated in
+    a child process. The task threads run under SCHED_RR: the test is
+    skipped if this is not allowed.
+_____________________________________________________________________________*/
+
+
+#include "easy_pthread_dispatch.h"
+#include "easy_pthread_sim.h"
+#include "easy_pthread_task.h"
+#include "test_check.h"
+#include <errno.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    LOCAL CONSTANTS
+_____________________________________________________________________________*/
+#define MS         1000000  // one millisecond                            [ns]
+#define N_TASKS    3        // number of tasks
+#define HORIZON_MS 80       // end of the simulation                      [ms]
+#define N_JOBS     15       // jobs started up to the horizon (included)
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    STRUCTURES DEFINITION
+_____________________________________________________________________________*/
+
+//-----------------------------------------------------------------------------
+/* Start of a job */
+struct job
+{
+    int task;   // task (position in the task set)
+    int start;  // start time                                            [ms]
+};
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    GLOBAL VARIABLES (definition)
+_____________________________________________________________________________*/
+static const int per[N_TASKS]  = {10, 20, 40};  // periods                [ms]
+static const int exec[N_TASKS] = {3, 5, 12};    // execution times        [ms]
+static const int pri[N_TASKS]  = {30, 20, 10};  // priorities
+
+static const struct job trace_fp[N_JOBS] = {
+    {0, 0},  {1, 3},  {2, 8},  {0, 10}, {0, 20}, {1, 23}, {0, 30}, {0, 40},
+    {1, 43}, {2, 48}, {0, 50}, {0, 60}, {1, 63}, {0, 70}, {0, 80}};
+static const struct job trace_edf[N_JOBS] = {
+    {0, 0},  {1, 3},  {2, 8},  {0, 10}, {0, 20}, {1, 26}, {0, 31}, {0, 40},
+    {1, 43}, {2, 48}, {0, 50}, {0, 60}, {1, 66}, {0, 71}, {0, 80}};
+static const int n_done[N_TASKS] = {8, 4, 2};   // completed jobs (both)
+static const int rt_fp[N_TASKS]  = {3, 5, 26};  // response times, FP    [ms]
+static const int rt_edf[N_TASKS] = {3, 5, 18};  // response times, EDF   [ms]
+
+static int        ind[N_TASKS];       // task indexes
+static struct job trace[N_JOBS + 1];  // jobs started so far
+static int        n_trace;            // number of jobs started so far
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    BODY:   Body of the j-th task: record the start of the job (the task
+            threads run one at a time in the simulation mode)
+_____________________________________________________________________________*/
+
+static int body(int j, void *ctx)
+{
+    int i;  // for-loop index
+
+    (void)ctx;
+
+    for (i = 0; i < N_TASKS && ind[i] != j; i++)
+        ;
+    if (n_trace <= N_JOBS) {
+        trace[n_trace].task  = i;
+        trace[n_trace].start = (int)(time_now_ns() / MS);
+        n_trace++;
+    }
+
+    return 0;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    TASK:   Task thread: run the periodic loop of the task
+_____________________________________________________________________________*/
+
+static void *task(void *arg)
+{
+    task_run_periodic(task_get_index(arg), body, NULL);
+
+    return NULL;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    SIMULATE:   Simulate the task set under policy, and check the jobs
+                against the expected trace exp and the response times
+                against rt.
+                Return the exit status of the child process
+_____________________________________________________________________________*/
+
+static int simulate(int policy, const struct job *exp, const int *rt)
+{
+    struct task_attr attr;
+    int              ret;
+    int              i;  // for-loop index
+
+    CHECK(sim_init(policy, (int64_t)HORIZON_MS * MS) == 0);
+    CHECK(sim_init(policy, (int64_t)HORIZON_MS * MS) == EBUSY);
+    CHECK(dispatch_start(1, 10, MS) == ENOTSUP);  // no real time
+
+    for (i = 0; i < N_TASKS; i++) {
+        task_attr_init(&attr);
+        ind[i] = task_alloc();
+        ret    = task_create_ns(task, ind[i], (int64_t)per[i] * MS,
+                                (int64_t)per[i] * MS, pri[i], &attr);
+        CHECK(ret == EINVAL);  // no declared execution time
+        attr.wcet_ns = (int64_t)exec[i] * MS;
+        ret = task_create_ns(task, ind[i], (int64_t)per[i] * MS,
+                             (int64_t)per[i] * MS, pri[i], &attr);
+        if (ret == EPERM) {
+            fprintf(stderr, "SCHED_RR not allowed: test skipped\n");
+            return TEST_SKIP;
+        }
+        CHECK(ret == 0);
+    }
+    for (i = 0; i < N_TASKS; i++)
+        task_wait_for_end(ind[i]);
+
+    CHECK(sim_is_finished());
+    CHECK(sim_now_ns() == (int64_t)HORIZON_MS * MS);
+
+    CHECK(n_trace == N_JOBS);
+    for (i = 0; i < n_trace && i < N_JOBS; i++) {
+        CHECK(trace[i].task == exp[i].task);
+        CHECK(trace[i].start == exp[i].start);
+    }
+
+    for (i = 0; i < N_TASKS; i++) {
+        CHECK(task_get_exec_count(ind[i]) == (unsigned long)n_done[i]);
+        CHECK(task_get_rt_min(ind[i]) == rt[i]);
+        CHECK(task_get_rt_max(ind[i]) == rt[i]);
+        CHECK(task_get_deadline_miss(ind[i]) == 0);
+    }
+
+    return TEST_RESULT();
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    RUN_CHILD:  Run simulate(policy, exp, rt) in a child process.
+                Return its exit status (EXIT_FAILURE if it did not exit)
+_____________________________________________________________________________*/
+
+static int run_child(int policy, const struct job *exp, const int *rt)
+{
+    pid_t pid;
+    int   status;
+
+    fflush(stderr);
+    pid = fork();
+    if (pid == 0)
+        exit(simulate(policy, exp, rt));
+    if (pid < 0 || waitpid(pid, &status, 0) < 0 || !WIFEXITED(status))
+        return EXIT_FAILURE;
+
+    return WEXITSTATUS(status);
+}
+//-----------------------------------------------------------------------------
+
+
+int main()
+{
+    int fp, edf;  // exit status of the simulations
+
+    fp  = run_child(SIM_FP, trace_fp, rt_fp);
+    edf = run_child(SIM_EDF, trace_edf, rt_edf);
+
+    if (fp == TEST_SKIP || edf == TEST_SKIP)
+        return TEST_SKIP;
+    CHECK(fp == EXIT_SUCCESS);
+    CHECK(edf == EXIT_SUCCESS);
+
+    return TEST_RESULT();
+}
+//-----------------------------------------------------------------------------
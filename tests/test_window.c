@@ -0,0 +1,147 @@
+//*****************************************************************************
+//************* TEST_WINDOW.C - Sliding-window statistics unit test ***********
+//*************              Author: Livio Bisogni               ***********
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Check the count, minimum, maximum, average, standard deviation and
+    deadline misses of a count window and of a time window, after each new
+    sample, against the ones computed by brute force on the samples that
+    should be in the window; then check that the rounding error left by a
+    huge sample does not outlive it.
+_____________________________________________________________________________*/
+
+
+#include "easy_pthread_window.h"
+#include "test_check.h"
+#include <math.h>
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    LOCAL CONSTANTS
+_____________________________________________________________________________*/
+#define N_VAL   20000  // number of samples
+#define CAP     16     // capacity of the windows
+#define SPAN    50     // time span of the time window                   [ns]
+#define REL_ERR 1e-9   // highest relative error of the average and std
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    GLOBAL VARIABLES (definition)
+_____________________________________________________________________________*/
+static double   x[N_VAL];   // samples
+static int64_t  t[N_VAL];   // times of the samples                       [ns]
+static unsigned dm[N_VAL];  // deadline misses of the samples
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    NEXT_RAND:  Return the next value of a linear congruential generator (the
+                same on every platform, unlike rand)
+_____________________________________________________________________________*/
+
+static uint32_t next_rand()
+{
+    static uint32_t r = 54321;
+
+    r = r * 1103515245u + 12345u;
+
+    return r >> 8;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    CHECK_WINDOW:   Check the window pointed by w, once the i-th sample was
+                    added, against the samples it should hold: the last CAP
+                    ones at most, and only the ones newer than t[i] - span
+                    if span is positive
+_____________________________________________________________________________*/
+
+static void check_window(const struct rt_window *w, long i, int64_t span)
+{
+    double        min, max;  // extreme samples
+    double        mean;      // average
+    double        m2;        // sum of squared deviations
+    double        err;       // highest error of the average and std
+    unsigned long n;         // number of samples
+    unsigned long n_dm;      // deadline misses
+    long          first;     // index of the oldest sample
+    long          k;         // for-loop index
+
+    first = i - CAP + 1 < 0 ? 0 : i - CAP + 1;
+    while (span > 0 && t[i] - t[first] >= span)
+        first++;
+
+    n    = i - first + 1;
+    min  = x[first];
+    max  = x[first];
+    mean = 0;
+    n_dm = 0;
+    for (k = first; k <= i; k++) {
+        min = x[k] < min ? x[k] : min;
+        max = x[k] > max ? x[k] : max;
+        mean += x[k];
+        n_dm += dm[k];
+    }
+    mean /= n;
+    m2 = 0;
+    for (k = first; k <= i; k++)
+        m2 += (x[k] - mean) * (x[k] - mean);
+
+    CHECK(rt_window_count(w) == n);
+    CHECK(rt_window_min(w) == min);
+    CHECK(rt_window_max(w) == max);
+    CHECK(rt_window_dm(w) == n_dm);
+
+    err = REL_ERR * max;
+    CHECK(fabs(rt_window_avg(w) - mean) <= err);
+    CHECK(fabs(rt_window_std(w) - (n > 1 ? sqrt(m2 / (n - 1)) : 0)) <= err);
+}
+//-----------------------------------------------------------------------------
+
+
+int main()
+{
+    struct rt_window cw;  // count window
+    struct rt_window tw;  // time window
+    long             i;   // for-loop index
+
+    CHECK(rt_window_init(&cw, 0, 0) == -1);
+    CHECK(rt_window_init(&cw, CAP, 0) == 0);
+    CHECK(rt_window_init(&tw, CAP, SPAN) == 0);
+    CHECK(rt_window_count(&cw) == 0);
+    CHECK(rt_window_min(&cw) == 0);
+    CHECK(rt_window_max(&cw) == 0);
+    CHECK(rt_window_std(&cw) == 0);
+
+    // Response times around 1 ms, some of them missing their deadline
+    for (i = 0; i < N_VAL; i++) {
+        x[i]  = 900000 + next_rand() % 200000;
+        t[i]  = (i > 0 ? t[i - 1] : 0) + 1 + next_rand() % 10;
+        dm[i] = x[i] > 1090000;
+        rt_window_add(&cw, x[i], t[i], dm[i]);
+        rt_window_add(&tw, x[i], t[i], dm[i]);
+        check_window(&cw, i, 0);
+        check_window(&tw, i, SPAN);
+    }
+    rt_window_free(&tw);
+
+    // A huge sample, then small ones, in the same window
+    rt_window_add(&cw, 1e12, 0, 0);
+    for (i = 0; i < N_VAL; i++) {
+        x[i]  = 1 + (i % 7) * 1e-3;
+        dm[i] = 0;
+        rt_window_add(&cw, x[i], 0, 0);
+        if (i >= 2 * CAP)  // the rounding error is gone by now
+            check_window(&cw, i, 0);
+    }
+    rt_window_free(&cw);
+    CHECK(rt_window_count(&cw) == 0);
+
+    return TEST_RESULT();
+}
+//-----------------------------------------------------------------------------
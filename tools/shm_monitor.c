@@ -0,0 +1,166 @@
+//*****************************************************************************
+//********* SHM_MONITOR.C - Out-of-process reader of live statistics **********
+//*********               Author: Livio Bisogni                 ***************
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Map (read-only) the shared-memory statistics segment published by a
+    process (see shm_stats_open) and print the statistics of its tasks every
+    interval milliseconds, count times (forever if 0). The monitored process
+    is never blocked nor slowed down by the reader.
+
+    Usage: shm_monitor [-i interval] [-n count] name
+    E.g.:  shm_monitor -i 500 /myapp
+_____________________________________________________________________________*/
+
+
+#include "easy_pthread_shm.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <float.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    LOCAL CONSTANTS
+_____________________________________________________________________________*/
+#define INTERVAL 1000  // default time between two prints               [ms]
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    MAP_SEGMENT:    Map the segment name read-only, and check its header.
+                    Return the header, or NULL in case of error
+_____________________________________________________________________________*/
+
+static const struct shm_stats_hdr *map_segment(const char *name)
+{
+    const struct shm_stats_hdr *hdr;
+    struct stat                 st;
+    void                       *addr;
+    int                         fd;
+
+    fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) {
+        perror(name);
+        return NULL;
+    }
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(*hdr)) {
+        fprintf(stderr, "%s: not a statistics segment\n", name);
+        close(fd);
+        return NULL;
+    }
+    addr = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        perror("mmap");
+        return NULL;
+    }
+
+    hdr = (const struct shm_stats_hdr *)addr;
+    if (memcmp(hdr->magic, SHM_MAGIC, sizeof(hdr->magic)) != 0 ||
+        hdr->version != SHM_VERSION ||
+        hdr->slot_size != sizeof(struct shm_stats_slot) ||
+        (size_t)st.st_size < sizeof(*hdr) + (size_t)hdr->n_slots *
+                                                sizeof(struct shm_stats_slot)) {
+        fprintf(stderr, "%s: not a statistics segment (version %d)\n", name,
+                SHM_VERSION);
+        munmap(addr, st.st_size);
+        return NULL;
+    }
+
+    return hdr;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    PRINT_STATS:    Print the statistics of the tasks in the segment hdr
+_____________________________________________________________________________*/
+
+static void print_stats(const struct shm_stats_hdr *hdr)
+{
+    const struct shm_stats_slot *slots;
+    struct shm_stats_slot        v;  // snapshot of a slot
+    uint32_t                     j;  // for-loop index
+
+    slots = (const struct shm_stats_slot *)(hdr + 1);
+
+    printf("pid %d%s\n", hdr->pid,
+           (kill(hdr->pid, 0) < 0 && errno == ESRCH) ? " (not running)" : "");
+    printf("%6s %10s %10s %10s %6s %10s %10s %10s %10s %8s %8s\n", "task",
+           "per [ms]", "dl [ms]", "ex_tot", "dm", "rt_min", "rt_avg",
+           "rt_max", "rt_std", "u_inst", "u_avg");
+
+    for (j = 0; j < hdr->n_slots; j++) {
+        if (shm_stats_read(&(slots[j]), &v) < 0 || v.task < 0)
+            continue;
+
+        printf("%6d %10.3f %10.3f %10llu %6d ", v.task, v.per_ns / 1e6,
+               v.dl_ns / 1e6, (unsigned long long)v.ex_tot, v.dm);
+        if (v.rt_min > v.rt_max)  // no activation yet
+            printf("%10s %10s %10s %10s %8s %8s\n", "-", "-", "-", "-", "-",
+                   "-");
+        else
+            printf("%10.3f %10.3f %10.3f %10.3f %8.4f %8.4f\n", v.rt_min,
+                   v.rt_avg, v.rt_max, v.rt_std, v.util_inst, v.util_avg);
+    }
+
+    printf("\n");
+    fflush(stdout);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    MAIN
+_____________________________________________________________________________*/
+
+int main(int argc, char *argv[])
+{
+    const struct shm_stats_hdr *hdr;
+    struct timespec             pause;     // time between two prints
+    int                         interval;  // time between two prints    [ms]
+    long                        count;     // number of prints; 0 for ever
+    long                        n;         // for-loop index
+    int                         opt;
+
+    interval = INTERVAL;
+    count    = 0;
+    while ((opt = getopt(argc, argv, "i:n:")) != -1) {
+        if (opt == 'i' && atoi(optarg) > 0)
+            interval = atoi(optarg);
+        else if (opt == 'n' && atol(optarg) >= 0)
+            count = atol(optarg);
+        else
+            optind = argc;  // usage error
+    }
+    if (optind != argc - 1) {
+        fprintf(stderr, "Usage: %s [-i interval] [-n count] name\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    hdr = map_segment(argv[optind]);
+    if (!hdr)
+        return EXIT_FAILURE;
+
+    pause.tv_sec  = interval / 1000;
+    pause.tv_nsec = (long)(interval % 1000) * 1000000;
+    for (n = 0; count == 0 || n < count; n++) {
+        if (n > 0)
+            nanosleep(&pause, NULL);
+        print_stats(hdr);
+    }
+
+    return EXIT_SUCCESS;
+}
+//-----------------------------------------------------------------------------
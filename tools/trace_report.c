@@ -0,0 +1,305 @@
+//*****************************************************************************
+//********* TRACE_REPORT.C - Offline analysis of the trace files **************
+//*********               Author: Livio Bisogni                 ***************
+//*****************************************************************************
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+                                  INSTRUCTIONS
+
+    Read the trace files written by the library (see trace_open) and print,
+    for each task, the number of activations and deadline misses, then min,
+    max, mean and percentiles of the response time (end - release) and of
+    the start latency (start - release), and a histogram of the response
+    time.
+
+    Usage: trace_report [-b bins] file...
+    E.g.:  trace_report /tmp/trace.*
+_____________________________________________________________________________*/
+
+
+#include "easy_pthread_trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    LOCAL CONSTANTS
+_____________________________________________________________________________*/
+#define MAX_TASKS 65536  // number of task indexes (see TASK_MAX)
+#define BINS      20     // default number of histogram bins
+#define BAR_LEN   50     // length of the longest histogram bar     [chars]
+#define BATCH     4096   // records read at once
+#define NS_PER_US 1000.0
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    STRUCTURES DEFINITION
+_____________________________________________________________________________*/
+
+//-----------------------------------------------------------------------------
+/* Samples of a task */
+struct task_samples
+{
+    size_t        n;    // number of samples
+    size_t        cap;  // capacity of rt and lat                    [samples]
+    int64_t      *rt;   // response times                                   [ns]
+    int64_t      *lat;  // start latencies                                  [ns]
+    unsigned long dm;   // number of deadline misses
+};
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    GLOBAL VARIABLES (definition)
+_____________________________________________________________________________*/
+static struct task_samples *tasks[MAX_TASKS];  // samples of each task, or NULL
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    ADD_RECORD: Add the samples of the record r to its task
+_____________________________________________________________________________*/
+
+static void add_record(const struct trace_rec *r)
+{
+    struct task_samples *ts;
+
+    ts = tasks[r->task];
+    if (!ts) {
+        ts = calloc(1, sizeof(*ts));
+        if (!ts) {
+            perror("calloc failed!");
+            exit(EXIT_FAILURE);
+        }
+        tasks[r->task] = ts;
+    }
+
+    if (ts->n == ts->cap) {
+        ts->cap = ts->cap ? 2 * ts->cap : 1024;
+        ts->rt  = realloc(ts->rt, ts->cap * sizeof(*(ts->rt)));
+        ts->lat = realloc(ts->lat, ts->cap * sizeof(*(ts->lat)));
+        if (!ts->rt || !ts->lat) {
+            perror("realloc failed!");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    ts->rt[ts->n]  = r->end - r->release;
+    ts->lat[ts->n] = r->start - r->release;
+    ts->n++;
+    if (r->flags & TRACE_DM)
+        ts->dm++;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    READ_FILE:  Read the valid records of the trace file named name.
+                Return 0 in case of success, -1 otherwise
+_____________________________________________________________________________*/
+
+static int read_file(const char *name)
+{
+    FILE            *f;
+    struct trace_hdr hdr;
+    struct trace_rec recs[BATCH];
+    uint64_t         left;  // records still to be read
+    size_t           got;   // records read by the last fread
+    size_t           i;     // for-loop index
+
+    f = fopen(name, "rb");
+    if (!f) {
+        perror(name);
+        return -1;
+    }
+
+    if (fread(&hdr, sizeof(hdr), 1, f) != 1 ||
+        memcmp(hdr.magic, TRACE_MAGIC, sizeof(hdr.magic)) != 0 ||
+        hdr.version != TRACE_VERSION ||
+        hdr.rec_size != sizeof(struct trace_rec)) {
+        fprintf(stderr, "%s: not a trace file (version %d)\n", name,
+                TRACE_VERSION);
+        fclose(f);
+        return -1;
+    }
+
+    left = hdr.n_rec < hdr.cap ? hdr.n_rec : hdr.cap;
+    while (left > 0) {
+        got = fread(recs, sizeof(recs[0]), left < BATCH ? left : BATCH, f);
+        if (got == 0)
+            break;  // truncated file
+        for (i = 0; i < got; i++)
+            if (recs[i].task < MAX_TASKS)
+                add_record(&recs[i]);
+        left -= got;
+    }
+
+    fclose(f);
+
+    return 0;
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    CMP_INT64:  Comparison function of qsort, for int64_t values
+_____________________________________________________________________________*/
+
+static int cmp_int64(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *)a;
+    int64_t y = *(const int64_t *)b;
+
+    return (x > y) - (x < y);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    PERCENTILE: Return the p-th percentile (nearest rank) of the n sorted
+                values v
+_____________________________________________________________________________*/
+
+static int64_t percentile(const int64_t *v, size_t n, double p)
+{
+    size_t k;  // rank of the percentile
+
+    k = (size_t)(p / 100 * n + 0.999999);
+    if (k < 1)
+        k = 1;
+    if (k > n)
+        k = n;
+
+    return v[k - 1];
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    PRINT_ROW:  Sort the n values v, then print a row of statistics (in [us])
+                labelled by name
+_____________________________________________________________________________*/
+
+static void print_row(const char *name, int64_t *v, size_t n)
+{
+    double sum;  // sum of the values                                      [ns]
+    size_t i;    // for-loop index
+
+    qsort(v, n, sizeof(*v), cmp_int64);
+
+    sum = 0;
+    for (i = 0; i < n; i++)
+        sum += v[i];
+
+    printf("  %-11s %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f\n", name,
+           v[0] / NS_PER_US, v[n - 1] / NS_PER_US, sum / n / NS_PER_US,
+           percentile(v, n, 50) / NS_PER_US, percentile(v, n, 90) / NS_PER_US,
+           percentile(v, n, 99) / NS_PER_US,
+           percentile(v, n, 99.9) / NS_PER_US);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    PRINT_HISTOGRAM:    Print a histogram of the n sorted values v, with
+                        bins equal-width bins between their min and max
+_____________________________________________________________________________*/
+
+static void print_histogram(const int64_t *v, size_t n, int bins)
+{
+    size_t *count;  // number of values of each bin
+    size_t  c_max;  // highest count
+    double  width;  // width of a bin                                      [ns]
+    size_t  i;      // for-loop index
+    int     b;      // bin index
+
+    count = calloc(bins, sizeof(*count));
+    if (!count) {
+        perror("calloc failed!");
+        exit(EXIT_FAILURE);
+    }
+
+    width = (double)(v[n - 1] - v[0]) / bins;
+    if (width <= 0)
+        width = 1;
+
+    for (i = 0; i < n; i++) {
+        b = (int)((v[i] - v[0]) / width);
+        count[b < bins ? b : bins - 1]++;
+    }
+
+    c_max = 0;
+    for (b = 0; b < bins; b++)
+        if (count[b] > c_max)
+            c_max = count[b];
+
+    for (b = 0; b < bins; b++) {
+        printf("  [%10.1f, %10.1f) %10zu ", (v[0] + b * width) / NS_PER_US,
+               (v[0] + (b + 1) * width) / NS_PER_US, count[b]);
+        for (i = 0; i < count[b] * BAR_LEN / c_max; i++)
+            putchar('#');
+        putchar('\n');
+    }
+
+    free(count);
+}
+//-----------------------------------------------------------------------------
+
+
+/*‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+    MAIN
+_____________________________________________________________________________*/
+
+int main(int argc, char *argv[])
+{
+    struct task_samples *ts;
+    int                  bins;  // number of histogram bins
+    int                  opt;
+    int                  err;   // 1 if a file could not be read
+    int                  j;     // for-loop index
+
+    bins = BINS;
+    while ((opt = getopt(argc, argv, "b:")) != -1) {
+        if (opt == 'b' && atoi(optarg) > 0)
+            bins = atoi(optarg);
+        else {
+            fprintf(stderr, "Usage: %s [-b bins] file...\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (optind >= argc) {
+        fprintf(stderr, "Usage: %s [-b bins] file...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    err = 0;
+    for (; optind < argc; optind++)
+        if (read_file(argv[optind]) < 0)
+            err = 1;
+
+    for (j = 0; j < MAX_TASKS; j++) {
+        ts = tasks[j];
+        if (!ts || ts->n == 0)
+            continue;
+
+        printf("Task %d: %zu activations, %lu deadline misses\n", j, ts->n,
+               ts->dm);
+        printf("  %-11s %10s %10s %10s %10s %10s %10s %10s\n", "[us]", "min",
+               "max", "mean", "p50", "p90", "p99", "p99.9");
+        print_row("response", ts->rt, ts->n);
+        print_row("start lat.", ts->lat, ts->n);
+        printf("  Response time histogram [us]:\n");
+        print_histogram(ts->rt, ts->n, bins);
+        printf("\n");
+
+        free(ts->rt);
+        free(ts->lat);
+        free(ts);
+    }
+
+    return err ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+//-----------------------------------------------------------------------------